@@ -0,0 +1,144 @@
+// Cells are stored in a map of rows to maps of columns, which every cell access goes
+// through. Filling a sheet inserts in order, reading it back looks up existing cells.
+
+#include "benchmark/benchmark.h"
+#include <xyxlnt/cell/cell.hpp>
+#include <xyxlnt/cell/cell_reference.hpp>
+#include <xyxlnt/workbook/workbook.hpp>
+#include <xyxlnt/worksheet/worksheet.hpp>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+class FilledSheet : public benchmark::Fixture
+{
+protected:
+    static constexpr xyxlnt::row_t Number_of_Rows = 1 << 12;
+    static constexpr xyxlnt::column_t::index_t Number_of_Columns = 16;
+    static constexpr size_t Number_of_Elements = Number_of_Rows * Number_of_Columns;
+
+    xyxlnt::workbook wb;
+    std::vector<xyxlnt::cell_reference> shuffled;
+
+public:
+    void SetUp(const ::benchmark::State &)
+    {
+        wb = xyxlnt::workbook();
+        auto ws = wb.active_sheet();
+        shuffled.clear();
+
+        for (xyxlnt::row_t row = 1; row <= Number_of_Rows; ++row)
+        {
+            for (xyxlnt::column_t::index_t column = 1; column <= Number_of_Columns; ++column)
+            {
+                ws.cell(column, row).value(static_cast<double>(row * column));
+                shuffled.emplace_back(column, row);
+            }
+        }
+
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+    }
+
+    void TearDown(const ::benchmark::State &)
+    {
+        // gbench is keeping the fixtures alive somewhere, need to clear the data after use
+        wb = xyxlnt::workbook();
+        shuffled = std::vector<xyxlnt::cell_reference>{};
+    }
+};
+
+} // namespace
+
+BENCHMARK_F(FilledSheet, cell_map_insert_in_order)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        state.PauseTiming();
+        xyxlnt::workbook fresh;
+        auto ws = fresh.active_sheet();
+        state.ResumeTiming();
+
+        for (xyxlnt::row_t row = 1; row <= Number_of_Rows; ++row)
+        {
+            for (xyxlnt::column_t::index_t column = 1; column <= Number_of_Columns; ++column)
+            {
+                ws.cell(column, row).value(1.0);
+            }
+        }
+
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(FilledSheet, cell_map_insert_shuffled)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        state.PauseTiming();
+        xyxlnt::workbook fresh;
+        auto ws = fresh.active_sheet();
+        state.ResumeTiming();
+
+        for (const auto &reference : shuffled)
+        {
+            ws.cell(reference).value(1.0);
+        }
+
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(FilledSheet, cell_map_lookup_in_order)
+(benchmark::State &state)
+{
+    const auto ws = wb.active_sheet();
+
+    while (state.KeepRunning())
+    {
+        for (xyxlnt::row_t row = 1; row <= Number_of_Rows; ++row)
+        {
+            for (xyxlnt::column_t::index_t column = 1; column <= Number_of_Columns; ++column)
+            {
+                benchmark::DoNotOptimize(ws.cell(column, row).value<double>());
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(FilledSheet, cell_map_lookup_shuffled)
+(benchmark::State &state)
+{
+    const auto ws = wb.active_sheet();
+
+    while (state.KeepRunning())
+    {
+        for (const auto &reference : shuffled)
+        {
+            benchmark::DoNotOptimize(ws.cell(reference).value<double>());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(FilledSheet, cell_map_has_cell_missing)
+(benchmark::State &state)
+{
+    const auto ws = wb.active_sheet();
+
+    while (state.KeepRunning())
+    {
+        for (const auto &reference : shuffled)
+        {
+            // the same rows, one column past the filled ones
+            benchmark::DoNotOptimize(ws.has_cell(xyxlnt::cell_reference(Number_of_Columns + 1, reference.row())));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
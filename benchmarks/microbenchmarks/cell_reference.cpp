@@ -0,0 +1,112 @@
+// Cell references are parsed for every cell read from a worksheet and formatted for
+// every cell written, and column letters are converted in both directions far more
+// often than anything else in the library.
+
+#include "benchmark/benchmark.h"
+#include <xyxlnt/cell/cell_reference.hpp>
+#include <xyxlnt/cell/index_types.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+class RandomReferences : public benchmark::Fixture
+{
+protected:
+    static constexpr size_t Number_of_Elements = 1 << 16;
+
+    std::vector<xyxlnt::cell_reference> references;
+    std::vector<std::string> strings;
+    std::vector<std::string> column_strings;
+    std::vector<xyxlnt::column_t::index_t> column_indices;
+
+public:
+    void SetUp(const ::benchmark::State &)
+    {
+        std::mt19937 gen(42);
+        // mostly narrow sheets, as in real files, with the occasional three letter column
+        std::uniform_int_distribution<xyxlnt::column_t::index_t> columns(1, 1000);
+        std::uniform_int_distribution<xyxlnt::row_t> rows(1, 1'000'000);
+
+        references.clear();
+        strings.clear();
+        column_strings.clear();
+        column_indices.clear();
+
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            references.emplace_back(columns(gen), rows(gen));
+            strings.push_back(references.back().to_string());
+            column_indices.push_back(references.back().column_index());
+            column_strings.push_back(references.back().column().column_string());
+        }
+    }
+
+    void TearDown(const ::benchmark::State &)
+    {
+        // gbench is keeping the fixtures alive somewhere, need to clear the data after use
+        references = std::vector<xyxlnt::cell_reference>{};
+        strings = std::vector<std::string>{};
+        column_strings = std::vector<std::string>{};
+        column_indices = std::vector<xyxlnt::column_t::index_t>{};
+    }
+};
+
+} // namespace
+
+BENCHMARK_F(RandomReferences, cell_reference_from_string)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            xyxlnt::cell_reference reference(strings[i]);
+            benchmark::DoNotOptimize(reference);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(RandomReferences, cell_reference_to_string)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            auto string = references[i].to_string();
+            benchmark::DoNotOptimize(string.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(RandomReferences, column_index_from_string)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            auto index = xyxlnt::column_t::column_index_from_string(column_strings[i]);
+            benchmark::DoNotOptimize(index);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(RandomReferences, column_string_from_index)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            auto string = xyxlnt::column_t::column_string_from_index(column_indices[i]);
+            benchmark::DoNotOptimize(string.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
@@ -0,0 +1,96 @@
+// Timeseries exports can hold millions of timestamp cells, each converted between an
+// Excel serial number and a datetime on the way in or out. These compare converting
+// one value per call with converting a whole column at once.
+
+#include "benchmark/benchmark.h"
+#include <xyxlnt/utils/datetime.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+
+class RandomTimestamps : public benchmark::Fixture
+{
+protected:
+    static constexpr size_t Number_of_Elements = 1 << 20;
+    static_assert(Number_of_Elements > 1'000'000, "ensure a decent set of random values is generated");
+
+    std::vector<double> numbers;
+    std::vector<xyxlnt::datetime> datetimes;
+
+public:
+    void SetUp(const ::benchmark::State &)
+    {
+        std::mt19937 gen(42);
+        // 1950-01-01 to 2100-01-01 with a time of day
+        std::uniform_real_distribution<double> dis(18264, 73051);
+
+        numbers.reserve(Number_of_Elements);
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            numbers.push_back(dis(gen));
+        }
+
+        datetimes.assign(Number_of_Elements, xyxlnt::datetime(1900, 1, 1));
+        xyxlnt::datetime::from_numbers(numbers.data(), numbers.size(), xyxlnt::calendar::windows_1900, datetimes.data());
+    }
+
+    void TearDown(const ::benchmark::State &)
+    {
+        // gbench is keeping the fixtures alive somewhere, need to clear the data after use
+        numbers = std::vector<double>{};
+        datetimes = std::vector<xyxlnt::datetime>{};
+    }
+};
+
+} // namespace
+
+BENCHMARK_F(RandomTimestamps, datetime_from_number)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            datetimes[i] = xyxlnt::datetime::from_number(numbers[i], xyxlnt::calendar::windows_1900);
+        }
+        benchmark::DoNotOptimize(datetimes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(RandomTimestamps, datetime_from_numbers)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        xyxlnt::datetime::from_numbers(numbers.data(), numbers.size(), xyxlnt::calendar::windows_1900, datetimes.data());
+        benchmark::DoNotOptimize(datetimes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(RandomTimestamps, datetime_to_number)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            numbers[i] = datetimes[i].to_number(xyxlnt::calendar::windows_1900);
+        }
+        benchmark::DoNotOptimize(numbers.data());
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(RandomTimestamps, datetime_to_numbers)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        xyxlnt::datetime::to_numbers(datetimes.data(), datetimes.size(), xyxlnt::calendar::windows_1900, numbers.data());
+        benchmark::DoNotOptimize(numbers.data());
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
@@ -4,6 +4,7 @@
 // - outputs up to 15 significant figures (excel only serialises numbers up to 15sf)
 
 #include "benchmark/benchmark.h"
+#include <xyxlnt/utils/numeric.hpp>
 #include <locale>
 #include <random>
 #include <sstream>
@@ -176,6 +177,32 @@ BENCHMARK_F(RandFloats, string_from_double_snprintf_fixed)
     }
 }
 
+// the serialiser used by the library, which avoids snprintf for most values
+BENCHMARK_F(RandFloats, string_from_double_xyxlnt)
+(benchmark::State &state)
+{
+    xyxlnt::detail::number_serialiser ser;
+    while (state.KeepRunning())
+    {
+        benchmark::DoNotOptimize(
+            ser.serialise(get_rand()));
+    }
+}
+
+// as above, writing into a caller-provided buffer with no allocation
+BENCHMARK_F(RandFloats, string_from_double_xyxlnt_buffer)
+(benchmark::State &state)
+{
+    xyxlnt::detail::number_serialiser ser;
+    char buf[32];
+    while (state.KeepRunning())
+    {
+        benchmark::DoNotOptimize(
+            ser.serialise(get_rand(), buf, sizeof(buf)));
+        benchmark::ClobberMemory();
+    }
+}
+
 // locale names are different between OS's, and std::from_chars is only complete in MSVC
 #ifdef _MSC_VER
 
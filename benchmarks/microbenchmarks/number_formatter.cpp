@@ -0,0 +1,106 @@
+// Number formats are applied to every cell whose displayed text is asked for, e.g. by
+// cell::to_string, so formatting is measured for a few representative format codes.
+
+#include "benchmark/benchmark.h"
+#include <detail/number_format/number_formatter.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+class RandomNumbers : public benchmark::Fixture
+{
+protected:
+    static constexpr size_t Number_of_Elements = 1 << 16;
+
+    std::vector<double> numbers;
+
+public:
+    void SetUp(const ::benchmark::State &)
+    {
+        std::mt19937 gen(42);
+        // positive and negative values which are also valid dates
+        std::uniform_real_distribution<double> dis(-50'000, 50'000);
+
+        numbers.clear();
+
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            numbers.push_back(dis(gen));
+        }
+    }
+
+    void TearDown(const ::benchmark::State &)
+    {
+        // gbench is keeping the fixtures alive somewhere, need to clear the data after use
+        numbers = std::vector<double>{};
+    }
+
+    void format_each(benchmark::State &state, const std::string &format)
+    {
+        xyxlnt::detail::number_formatter formatter(format, xyxlnt::calendar::windows_1900);
+
+        while (state.KeepRunning())
+        {
+            for (size_t i = 0; i < Number_of_Elements; ++i)
+            {
+                auto text = formatter.format_number(numbers[i]);
+                benchmark::DoNotOptimize(text.data());
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+    }
+
+    void format_all(benchmark::State &state, const std::string &format)
+    {
+        xyxlnt::detail::number_formatter formatter(format, xyxlnt::calendar::windows_1900);
+        xyxlnt::detail::formatted_numbers output;
+
+        while (state.KeepRunning())
+        {
+            output.clear();
+            formatter.format_numbers(numbers.data(), numbers.size(), output);
+            benchmark::DoNotOptimize(output.text.data());
+        }
+        state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+    }
+};
+
+} // namespace
+
+BENCHMARK_F(RandomNumbers, format_number_general)
+(benchmark::State &state)
+{
+    format_each(state, "General");
+}
+
+BENCHMARK_F(RandomNumbers, format_number_thousands)
+(benchmark::State &state)
+{
+    format_each(state, "#,##0.00;[Red]-#,##0.00");
+}
+
+BENCHMARK_F(RandomNumbers, format_number_percentage)
+(benchmark::State &state)
+{
+    format_each(state, "0.0%");
+}
+
+BENCHMARK_F(RandomNumbers, format_number_date)
+(benchmark::State &state)
+{
+    // dates only cover positive serials
+    for (auto &number : numbers)
+    {
+        number = number < 0 ? -number : number;
+    }
+
+    format_each(state, "yyyy-mm-dd hh:mm:ss");
+}
+
+BENCHMARK_F(RandomNumbers, format_numbers_thousands)
+(benchmark::State &state)
+{
+    format_all(state, "#,##0.00;[Red]-#,##0.00");
+}
@@ -0,0 +1,108 @@
+// Every string added to the shared string table is hashed to find an existing copy,
+// so the hash of plain text has to be cheap. Formatted runs are rarer but also hashed.
+
+#include "benchmark/benchmark.h"
+#include <xyxlnt/cell/rich_text.hpp>
+#include <xyxlnt/cell/rich_text_run.hpp>
+#include <xyxlnt/styles/font.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+class RandomTexts : public benchmark::Fixture
+{
+protected:
+    static constexpr size_t Number_of_Elements = 1 << 16;
+
+    std::vector<std::string> plain;
+    std::vector<xyxlnt::rich_text> texts;
+    std::vector<xyxlnt::rich_text> formatted;
+
+public:
+    void SetUp(const ::benchmark::State &)
+    {
+        std::mt19937 gen(42);
+        // typical cell text is a word or a short phrase
+        std::uniform_int_distribution<size_t> lengths(1, 40);
+        std::uniform_int_distribution<int> letters('a', 'z');
+
+        plain.clear();
+        texts.clear();
+        formatted.clear();
+
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            std::string text(lengths(gen), ' ');
+
+            for (auto &c : text)
+            {
+                c = static_cast<char>(letters(gen));
+            }
+
+            plain.push_back(text);
+            texts.emplace_back(text);
+
+            xyxlnt::rich_text runs;
+            runs.add_run(xyxlnt::rich_text_run{text, xyxlnt::font().bold(true), false});
+            runs.add_run(xyxlnt::rich_text_run{text, xyxlnt::font().italic(true).size(14), false});
+            formatted.push_back(runs);
+        }
+    }
+
+    void TearDown(const ::benchmark::State &)
+    {
+        // gbench is keeping the fixtures alive somewhere, need to clear the data after use
+        plain = std::vector<std::string>{};
+        texts = std::vector<xyxlnt::rich_text>{};
+        formatted = std::vector<xyxlnt::rich_text>{};
+    }
+};
+
+} // namespace
+
+BENCHMARK_F(RandomTexts, rich_text_hash_string)
+(benchmark::State &state)
+{
+    xyxlnt::rich_text_hash hash;
+
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            benchmark::DoNotOptimize(hash(plain[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(RandomTexts, rich_text_hash_plain)
+(benchmark::State &state)
+{
+    xyxlnt::rich_text_hash hash;
+
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            benchmark::DoNotOptimize(hash(texts[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+BENCHMARK_F(RandomTexts, rich_text_hash_formatted)
+(benchmark::State &state)
+{
+    xyxlnt::rich_text_hash hash;
+
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            benchmark::DoNotOptimize(hash(formatted[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
@@ -0,0 +1,87 @@
+// Styling a cell goes through stylesheet::find_or_create to share one format between
+// every cell that looks the same, so its cost is paid once per styled cell.
+
+#include "benchmark/benchmark.h"
+#include <xyxlnt/cell/cell.hpp>
+#include <xyxlnt/styles/fill.hpp>
+#include <xyxlnt/styles/font.hpp>
+#include <xyxlnt/workbook/workbook.hpp>
+#include <xyxlnt/worksheet/worksheet.hpp>
+#include <vector>
+
+namespace {
+
+class StyledCells : public benchmark::Fixture
+{
+protected:
+    static constexpr size_t Number_of_Elements = 1 << 14;
+    static constexpr size_t Number_of_Styles = 64;
+
+    std::vector<xyxlnt::font> fonts;
+    std::vector<xyxlnt::fill> fills;
+
+public:
+    void SetUp(const ::benchmark::State &)
+    {
+        fonts.clear();
+        fills.clear();
+
+        for (size_t i = 0; i < Number_of_Styles; ++i)
+        {
+            fonts.push_back(xyxlnt::font().bold(i % 2 == 0).size(10 + static_cast<double>(i % 8)));
+            fills.push_back(xyxlnt::fill::solid(xyxlnt::rgb_color(
+                static_cast<std::uint8_t>(i * 4), 0, static_cast<std::uint8_t>(255 - i * 4))));
+        }
+    }
+
+    void TearDown(const ::benchmark::State &)
+    {
+        // gbench is keeping the fixtures alive somewhere, need to clear the data after use
+        fonts = std::vector<xyxlnt::font>{};
+        fills = std::vector<xyxlnt::fill>{};
+    }
+};
+
+} // namespace
+
+// each cell gets a format that already exists after the first few cells
+BENCHMARK_F(StyledCells, find_or_create_existing)
+(benchmark::State &state)
+{
+    while (state.KeepRunning())
+    {
+        state.PauseTiming();
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            auto cell = ws.cell(static_cast<xyxlnt::column_t::index_t>(1 + i % 16), static_cast<xyxlnt::row_t>(1 + i / 16));
+            cell.font(fonts[i % Number_of_Styles]);
+            cell.fill(fills[(i / Number_of_Styles) % Number_of_Styles]);
+        }
+
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
+
+// the same cell is restyled over and over, leaving unreferenced formats behind
+BENCHMARK_F(StyledCells, find_or_create_restyle)
+(benchmark::State &state)
+{
+    xyxlnt::workbook wb;
+    auto cell = wb.active_sheet().cell("A1");
+
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < Number_of_Elements; ++i)
+        {
+            cell.font(fonts[i % Number_of_Styles]);
+        }
+
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * Number_of_Elements);
+}
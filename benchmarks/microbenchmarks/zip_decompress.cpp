@@ -0,0 +1,88 @@
+// Every part of a workbook is inflated by zip_streambuf_decompress as it's parsed, so
+// its throughput bounds how fast large worksheets can be loaded.
+
+#include "benchmark/benchmark.h"
+#include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/zstream.hpp>
+#include <xyxlnt/utils/path.hpp>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+class CompressedWorksheet : public benchmark::Fixture
+{
+protected:
+    const xyxlnt::path part{"xl/worksheets/sheet1.xml"};
+
+    std::vector<std::uint8_t> archive;
+    size_t uncompressed_size = 0;
+
+public:
+    void SetUp(const ::benchmark::State &)
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> dis(0, 1'000'000);
+
+        // sheetData markup compresses about as well as a real worksheet does
+        std::string xml = "<sheetData>";
+
+        for (int row = 1; row <= 20'000; ++row)
+        {
+            xml += "<row r=\"" + std::to_string(row) + "\">";
+
+            for (char column = 'A'; column <= 'J'; ++column)
+            {
+                xml += "<c r=\"" + std::string(1, column) + std::to_string(row) + "\"><v>"
+                    + std::to_string(dis(gen)) + "</v></c>";
+            }
+
+            xml += "</row>";
+        }
+
+        xml += "</sheetData>";
+        uncompressed_size = xml.size();
+
+        archive.clear();
+        xyxlnt::detail::vector_ostreambuf archive_buffer(archive);
+        std::ostream archive_stream(&archive_buffer);
+        {
+            xyxlnt::detail::ozstream writer(archive_stream);
+            auto part_buffer = writer.open(part);
+            std::ostream(part_buffer.get()) << xml;
+        }
+    }
+
+    void TearDown(const ::benchmark::State &)
+    {
+        // gbench is keeping the fixtures alive somewhere, need to clear the data after use
+        archive = std::vector<std::uint8_t>{};
+    }
+};
+
+} // namespace
+
+BENCHMARK_F(CompressedWorksheet, zip_decompress)
+(benchmark::State &state)
+{
+    std::vector<char> chunk(4096);
+
+    while (state.KeepRunning())
+    {
+        xyxlnt::detail::vector_istreambuf archive_buffer(archive);
+        std::istream archive_stream(&archive_buffer);
+        xyxlnt::detail::izstream reader(archive_stream);
+        auto part_buffer = reader.open(part);
+
+        // read in chunks the way the XML parser does
+        while (part_buffer->sgetn(chunk.data(), static_cast<std::streamsize>(chunk.size())) > 0)
+        {
+            benchmark::DoNotOptimize(chunk.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(uncompressed_size));
+}
@@ -48,11 +48,29 @@ void run_save_test(const xyxlnt::path &file, int runs = 10)
 }
 } // namespace
 
-int main()
+// Loads and saves each file given on the command line, or benchmarks/data/large.xlsx.
+// Generated workbooks of a chosen size are measured by benchmark-workloads instead.
+int main(int argc, char *argv[])
 {
-    run_load_test(path_helper::benchmark_file("large.xlsx"));
-    run_load_test(path_helper::benchmark_file("very_large.xlsx"));
+    std::vector<xyxlnt::path> files;
 
-    run_save_test(path_helper::benchmark_file("large.xlsx"));
-    run_save_test(path_helper::benchmark_file("very_large.xlsx"));
+    for (int i = 1; i < argc; ++i)
+    {
+        files.emplace_back(argv[i]);
+    }
+
+    if (files.empty())
+    {
+        files.push_back(path_helper::benchmark_file("large.xlsx"));
+    }
+
+    for (const auto &file : files)
+    {
+        run_load_test(file);
+    }
+
+    for (const auto &file : files)
+    {
+        run_save_test(file);
+    }
 }
\ No newline at end of file
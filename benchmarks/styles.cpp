@@ -217,12 +217,50 @@ void read_formats_profile(xyxlnt::workbook &wb, int rows_number, int columns_num
 		<< ". formats count " << formats.size() << std::endl;
 }
 
+// Gives each of font_count cells its own font so that the stylesheet holds font_count
+// fonts and formats, then restyles every cell with one shared font. This measures
+// find-or-create of formats and components against a large stylesheet and the
+// garbage collection of the fonts and formats left unreferenced.
+void large_stylesheet_profile(int font_count)
+{
+	using xyxlnt::benchmarks::current_time;
+
+	xyxlnt::workbook wb;
+	auto worksheet = wb.active_sheet();
+	auto start = current_time();
+
+	for (int i = 0; i < font_count; i++)
+	{
+		auto cell = worksheet.cell(xyxlnt::cell_reference(1, static_cast<xyxlnt::row_t>(i + 1)));
+		cell.value(i);
+		cell.font(xyxlnt::font().name("Font " + std::to_string(i)).size(11));
+	}
+
+	auto elapsed = current_time() - start;
+
+	std::cout << "elapsed " << elapsed / 1000.0 << ". create large stylesheet. number of fonts " << font_count << std::endl;
+
+	start = current_time();
+
+	for (int i = 0; i < font_count; i++)
+	{
+		worksheet.cell(xyxlnt::cell_reference(1, static_cast<xyxlnt::row_t>(i + 1))).font(xyxlnt::font().bold(true));
+	}
+
+	elapsed = current_time() - start;
+
+	std::cout << "elapsed " << elapsed / 1000.0 << ". restyle large stylesheet." << std::endl;
+
+	to_save_profile(wb, "temp-large-stylesheet.xlsx");
+}
+
 } // namespace
 
 int main(int argc, char * argv[])
 {
     int rows_number = 1000;
 	int columns_number = 10;
+	int font_count = 60000;
 
 	try 
 	{
@@ -232,6 +270,9 @@ int main(int argc, char * argv[])
 		if (argc > 2)
 			columns_number = std::stoi(argv[2]);
 
+		if (argc > 3)
+			font_count = std::stoi(argv[3]);
+
 		std::cout << "started. number of rows " << rows_number << ", number of columns " << columns_number << std::endl;
 		auto wb = non_optimized_workbook_formats(rows_number, columns_number);
 		auto f = "temp-formats.xlsx";
@@ -240,6 +281,8 @@ int main(int argc, char * argv[])
 		xyxlnt::workbook load_formats_wb;
 		to_load_profile(load_formats_wb, f);
 		read_formats_profile(load_formats_wb, rows_number, columns_number);
+
+		large_stylesheet_profile(font_count);
 	}
 	catch(std::exception& ex)
 	{
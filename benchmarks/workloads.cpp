@@ -0,0 +1,647 @@
+// Copyright (c) 2017-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+// Generates workbooks of several shapes deterministically and measures how long the
+// library takes to build, save, load, iterate, clear, stream-write and stream-read each one,
+// along with the peak resident set size. Results are written as JSON so they can be
+// compared between releases.
+//
+// peak_rss_bytes is the largest resident set size of the whole process, code and all, while
+// the workload ran. On Linux the high-water mark is reset before each workload (after handing
+// freed heap memory back to the system) so every workload reports its own peak and
+// peak_rss_scope is "workload". Elsewhere the peak can't be reset, so it covers everything the
+// process did up to the end of the workload and peak_rss_scope is "process"; run a single
+// --workload per process to compare those.
+//
+// usage: benchmark-workloads [--scale N] [--runs N] [--seed N] [--workload NAME]...
+//                            [--output FILE]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <xyxlnt/xyxlnt.hpp>
+
+namespace {
+
+using milliseconds_d = std::chrono::duration<double, std::milli>;
+
+// Starts a new peak resident set size measurement. Returns false if the platform keeps
+// a single high-water mark for the lifetime of the process.
+bool reset_peak_rss()
+{
+#if defined(__linux__)
+#if defined(__GLIBC__)
+    // otherwise memory freed by the previous workload still counts as resident
+    malloc_trim(0);
+#endif
+    // "5" resets the VmHWM reported in /proc/self/status to the current resident set size
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+    clear_refs.close();
+
+    return !clear_refs.fail();
+#else
+    return false;
+#endif
+}
+
+// Returns the largest resident set size the process has had since the last successful
+// reset_peak_rss, or since it started, in bytes. Returns 0 if the platform doesn't report it.
+std::uint64_t peak_rss_bytes()
+{
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+
+    while (std::getline(status, line))
+    {
+        // e.g. "VmHWM:\t  123456 kB"
+        if (line.compare(0, 6, "VmHWM:") == 0)
+        {
+            return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+        }
+    }
+#endif
+
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return static_cast<std::uint64_t>(counters.PeakWorkingSetSize);
+    }
+
+    return 0;
+#elif defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+
+#if defined(__APPLE__)
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return 0;
+#endif
+}
+
+// std::mt19937's output is fully specified but the standard distributions aren't, so
+// values are derived from it directly to produce the same workbooks everywhere.
+class generator
+{
+public:
+    explicit generator(std::uint32_t seed)
+        : engine_(seed)
+    {
+    }
+
+    std::uint32_t below(std::uint32_t bound)
+    {
+        return engine_() % bound;
+    }
+
+    double number()
+    {
+        return static_cast<double>(engine_()) / 4294967296.0 * 1000000.0;
+    }
+
+private:
+    std::mt19937 engine_;
+};
+
+// Where a workload puts its cells: either a workbook in memory or a streaming writer.
+// Cells must be added row by row, left to right, within each sheet.
+class cell_sink
+{
+public:
+    virtual ~cell_sink() = default;
+
+    virtual void begin_sheet(const std::string &title) = 0;
+
+    virtual xyxlnt::cell add_cell(xyxlnt::column_t::index_t column, xyxlnt::row_t row) = 0;
+};
+
+class workbook_sink : public cell_sink
+{
+public:
+    explicit workbook_sink(xyxlnt::workbook &wb)
+        : wb_(wb),
+          sheets_(0)
+    {
+    }
+
+    void begin_sheet(const std::string &title) override
+    {
+        ws_ = sheets_++ == 0 ? wb_.active_sheet() : wb_.create_sheet();
+        ws_.title(title);
+    }
+
+    xyxlnt::cell add_cell(xyxlnt::column_t::index_t column, xyxlnt::row_t row) override
+    {
+        return ws_.cell(column, row);
+    }
+
+private:
+    xyxlnt::workbook &wb_;
+    xyxlnt::worksheet ws_;
+    std::size_t sheets_;
+};
+
+class streaming_sink : public cell_sink
+{
+public:
+    explicit streaming_sink(xyxlnt::streaming_workbook_writer &writer)
+        : writer_(writer)
+    {
+    }
+
+    void begin_sheet(const std::string &title) override
+    {
+        writer_.add_worksheet(title);
+    }
+
+    xyxlnt::cell add_cell(xyxlnt::column_t::index_t column, xyxlnt::row_t row) override
+    {
+        return writer_.add_cell(xyxlnt::cell_reference(column, row));
+    }
+
+private:
+    xyxlnt::streaming_workbook_writer &writer_;
+};
+
+struct workload
+{
+    const char *name;
+    const char *description;
+    std::function<void(cell_sink &, generator &, std::size_t scale)> generate;
+};
+
+void dense_numeric(cell_sink &sink, generator &gen, std::size_t scale)
+{
+    const auto rows = static_cast<xyxlnt::row_t>(5000 * scale);
+    sink.begin_sheet("Numbers");
+
+    for (xyxlnt::row_t row = 1; row <= rows; ++row)
+    {
+        for (xyxlnt::column_t::index_t column = 1; column <= 20; ++column)
+        {
+            sink.add_cell(column, row).value(gen.number());
+        }
+    }
+}
+
+void string_heavy(cell_sink &sink, generator &gen, std::size_t scale)
+{
+    const auto rows = static_cast<xyxlnt::row_t>(5000 * scale);
+    const auto vocabulary = static_cast<std::uint32_t>(1000 * scale);
+    sink.begin_sheet("Strings");
+
+    for (xyxlnt::row_t row = 1; row <= rows; ++row)
+    {
+        for (xyxlnt::column_t::index_t column = 1; column <= 10; ++column)
+        {
+            // squaring skews the choice towards common words like real text
+            const auto pick = gen.below(vocabulary);
+            const auto word = static_cast<std::uint64_t>(pick) * pick / vocabulary;
+            sink.add_cell(column, row).value("word " + std::to_string(word));
+        }
+    }
+}
+
+void heavily_styled(cell_sink &sink, generator &gen, std::size_t scale)
+{
+    static const char *const number_formats[] = {"0.00", "#,##0", "0%", "yyyy-mm-dd", "0.00E+00"};
+    static const char *const font_names[] = {"Calibri", "Arial", "Tahoma", "Times New Roman"};
+
+    const auto rows = static_cast<xyxlnt::row_t>(2000 * scale);
+    sink.begin_sheet("Styles");
+
+    for (xyxlnt::row_t row = 1; row <= rows; ++row)
+    {
+        for (xyxlnt::column_t::index_t column = 1; column <= 10; ++column)
+        {
+            auto cell = sink.add_cell(column, row);
+            cell.value(gen.number());
+
+            const auto style = gen.below(64);
+            cell.font(xyxlnt::font()
+                          .name(font_names[style % 4])
+                          .bold((style & 4) != 0)
+                          .italic((style & 8) != 0)
+                          .size(10 + static_cast<double>(style % 3)));
+            cell.fill(xyxlnt::fill::solid(xyxlnt::rgb_color(
+                static_cast<std::uint8_t>(style * 4), 128, static_cast<std::uint8_t>(255 - style * 4))));
+            cell.number_format(xyxlnt::number_format(number_formats[style % 5]));
+        }
+    }
+}
+
+void sparse(cell_sink &sink, generator &gen, std::size_t scale)
+{
+    const auto cells = 20000 * scale;
+    sink.begin_sheet("Sparse");
+
+    xyxlnt::row_t row = 0;
+
+    for (std::size_t i = 0; i < cells; ++i)
+    {
+        row += 1 + gen.below(40);
+        const auto column = static_cast<xyxlnt::column_t::index_t>(1 + gen.below(200));
+        sink.add_cell(column, row).value(gen.number());
+    }
+}
+
+void formula_heavy(cell_sink &sink, generator &gen, std::size_t scale)
+{
+    const auto rows = static_cast<xyxlnt::row_t>(5000 * scale);
+    sink.begin_sheet("Formulae");
+
+    for (xyxlnt::row_t row = 1; row <= rows; ++row)
+    {
+        const auto r = std::to_string(row);
+
+        sink.add_cell(1, row).value(gen.number());
+        sink.add_cell(2, row).value(gen.number());
+        sink.add_cell(3, row).formula("=A" + r + "+B" + r);
+        sink.add_cell(4, row).formula("=IF(C" + r + ">1000000,C" + r + "/2,C" + r + "*2)");
+        sink.add_cell(5, row).formula("=SUM(A$1:A" + r + ")");
+    }
+}
+
+void many_sheets(cell_sink &sink, generator &gen, std::size_t scale)
+{
+    const auto sheets = 100 * scale;
+
+    for (std::size_t sheet = 1; sheet <= sheets; ++sheet)
+    {
+        sink.begin_sheet("Sheet " + std::to_string(sheet));
+
+        for (xyxlnt::row_t row = 1; row <= 50; ++row)
+        {
+            for (xyxlnt::column_t::index_t column = 1; column <= 10; ++column)
+            {
+                auto cell = sink.add_cell(column, row);
+
+                if (column % 2 == 0)
+                {
+                    cell.value("label " + std::to_string(gen.below(500)));
+                }
+                else
+                {
+                    cell.value(gen.number());
+                }
+            }
+        }
+    }
+}
+
+const std::vector<workload> &workloads()
+{
+    static const std::vector<workload> all = {
+        {"dense_numeric", "20 columns of random numbers", dense_numeric},
+        {"string_heavy", "10 columns of strings drawn from a skewed vocabulary", string_heavy},
+        {"heavily_styled", "numbers with one of 64 font, fill and number format combinations", heavily_styled},
+        {"sparse", "one number every 1 to 40 rows in a random one of 200 columns", sparse},
+        {"formula_heavy", "two numbers and three formulae per row", formula_heavy},
+        {"many_sheets", "many small sheets of numbers and labels", many_sheets},
+    };
+
+    return all;
+}
+
+// The minimum and mean of the runs of one operation.
+struct timing
+{
+    std::vector<double> runs;
+
+    void add(std::chrono::steady_clock::duration elapsed)
+    {
+        runs.push_back(milliseconds_d(elapsed).count());
+    }
+
+    double min() const
+    {
+        return *std::min_element(runs.begin(), runs.end());
+    }
+
+    double mean() const
+    {
+        double total = 0;
+
+        for (auto run : runs)
+        {
+            total += run;
+        }
+
+        return total / static_cast<double>(runs.size());
+    }
+};
+
+struct result
+{
+    const workload *measured;
+    std::size_t sheets = 0;
+    std::uint64_t cells = 0;
+    std::size_t file_bytes = 0;
+    std::uint64_t peak_rss_bytes = 0;
+    bool peak_rss_per_workload = false;
+    std::vector<std::pair<std::string, timing>> timings;
+};
+
+template <typename Operation>
+void time_operation(timing &destination, Operation operation)
+{
+    const auto start = std::chrono::steady_clock::now();
+    operation();
+    destination.add(std::chrono::steady_clock::now() - start);
+}
+
+result run_workload(const workload &measured, std::size_t scale, std::uint32_t seed, std::size_t runs)
+{
+    result measurement;
+    measurement.measured = &measured;
+    measurement.peak_rss_per_workload = reset_peak_rss();
+
+    timing build, save, load, iterate, clear, stream_write, stream_read;
+    std::vector<std::uint8_t> data;
+
+    for (std::size_t run = 0; run < runs; ++run)
+    {
+        xyxlnt::workbook wb;
+
+        time_operation(build, [&]() {
+            generator gen(seed);
+            workbook_sink sink(wb);
+            measured.generate(sink, gen, scale);
+        });
+
+        data.clear();
+        time_operation(save, [&]() { wb.save(data); });
+
+        xyxlnt::workbook loaded;
+        time_operation(load, [&]() { loaded.load(data); });
+
+        std::uint64_t cells = 0;
+        double checksum = 0;
+
+        time_operation(iterate, [&]() {
+            for (auto ws : loaded)
+            {
+                for (auto row : ws.rows())
+                {
+                    for (auto cell : row)
+                    {
+                        ++cells;
+
+                        if (cell.data_type() == xyxlnt::cell::type::number)
+                        {
+                            checksum += cell.value<double>();
+                        }
+                    }
+                }
+            }
+        });
+
+        measurement.sheets = loaded.sheet_count();
+        measurement.cells = cells;
+        measurement.file_bytes = data.size();
+
+        time_operation(clear, [&]() { loaded.clear(); });
+
+        std::vector<std::uint8_t> streamed;
+
+        time_operation(stream_write, [&]() {
+            xyxlnt::streaming_workbook_writer writer;
+            writer.open(streamed);
+            generator gen(seed);
+            streaming_sink sink(writer);
+            measured.generate(sink, gen, scale);
+            writer.close();
+        });
+
+        std::uint64_t streamed_cells = 0;
+
+        time_operation(stream_read, [&]() {
+            xyxlnt::streaming_workbook_reader reader;
+            reader.open(streamed);
+
+            for (const auto &title : reader.sheet_titles())
+            {
+                reader.begin_worksheet(title);
+
+                while (reader.has_cell())
+                {
+                    auto cell = reader.read_cell();
+                    checksum += static_cast<double>(cell.row());
+                    ++streamed_cells;
+                }
+
+                reader.end_worksheet();
+            }
+
+            reader.close();
+        });
+
+        // keeps the loops from being optimised away
+        if (checksum == -1.0)
+        {
+            std::cerr << streamed_cells << '\n';
+        }
+    }
+
+    measurement.peak_rss_bytes = peak_rss_bytes();
+    measurement.timings = {
+        {"build", build},
+        {"save", save},
+        {"load", load},
+        {"iterate", iterate},
+        {"clear", clear},
+        {"stream_write", stream_write},
+        {"stream_read", stream_read},
+    };
+
+    return measurement;
+}
+
+void write_json(std::ostream &out, const std::vector<result> &results, std::size_t scale, std::uint32_t seed,
+    std::size_t runs)
+{
+    out << "{\n";
+    out << "  \"benchmark\": \"workloads\",\n";
+    out << "  \"scale\": " << scale << ",\n";
+    out << "  \"seed\": " << seed << ",\n";
+    out << "  \"runs\": " << runs << ",\n";
+    out << "  \"workloads\": [";
+
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const auto &measurement = results[i];
+
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\n";
+        out << "      \"name\": \"" << measurement.measured->name << "\",\n";
+        out << "      \"description\": \"" << measurement.measured->description << "\",\n";
+        out << "      \"sheets\": " << measurement.sheets << ",\n";
+        out << "      \"cells\": " << measurement.cells << ",\n";
+        out << "      \"file_bytes\": " << measurement.file_bytes << ",\n";
+        out << "      \"peak_rss_bytes\": " << measurement.peak_rss_bytes << ",\n";
+        out << "      \"peak_rss_scope\": \"" << (measurement.peak_rss_per_workload ? "workload" : "process") << "\",\n";
+        out << "      \"milliseconds\": {";
+
+        for (std::size_t j = 0; j < measurement.timings.size(); ++j)
+        {
+            const auto &operation = measurement.timings[j];
+
+            out << (j == 0 ? "\n" : ",\n");
+            out << "        \"" << operation.first << "\": {\"min\": " << operation.second.min()
+                << ", \"mean\": " << operation.second.mean() << "}";
+        }
+
+        out << "\n      }\n";
+        out << "    }";
+    }
+
+    out << "\n  ]\n";
+    out << "}\n";
+}
+
+int usage(const char *program)
+{
+    std::cerr << "usage: " << program
+              << " [--scale N] [--runs N] [--seed N] [--workload NAME]... [--output FILE]\n\nworkloads:\n";
+
+    for (const auto &available : workloads())
+    {
+        std::cerr << "  " << available.name << ": " << available.description << '\n';
+    }
+
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::size_t scale = 1;
+    std::size_t runs = 3;
+    std::uint32_t seed = 5489; // std::mt19937::default_seed
+    std::vector<std::string> selected;
+    std::string output;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string option = argv[i];
+
+        if (i + 1 >= argc)
+        {
+            return usage(argv[0]);
+        }
+
+        const std::string value = argv[++i];
+
+        if (option == "--scale")
+        {
+            scale = static_cast<std::size_t>(std::max(1L, std::strtol(value.c_str(), nullptr, 10)));
+        }
+        else if (option == "--runs")
+        {
+            runs = static_cast<std::size_t>(std::max(1L, std::strtol(value.c_str(), nullptr, 10)));
+        }
+        else if (option == "--seed")
+        {
+            seed = static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        }
+        else if (option == "--workload")
+        {
+            selected.push_back(value);
+        }
+        else if (option == "--output")
+        {
+            output = value;
+        }
+        else
+        {
+            return usage(argv[0]);
+        }
+    }
+
+    for (const auto &name : selected)
+    {
+        const auto &all = workloads();
+
+        if (std::none_of(all.begin(), all.end(), [&name](const workload &w) { return name == w.name; }))
+        {
+            std::cerr << "unknown workload " << name << "\n\n";
+            return usage(argv[0]);
+        }
+    }
+
+    std::vector<result> results;
+
+    for (const auto &candidate : workloads())
+    {
+        if (!selected.empty() && std::find(selected.begin(), selected.end(), candidate.name) == selected.end())
+        {
+            continue;
+        }
+
+        std::cerr << candidate.name << "..." << std::endl;
+        results.push_back(run_workload(candidate, scale, seed, runs));
+    }
+
+    if (output.empty())
+    {
+        write_json(std::cout, results, scale, seed, runs);
+    }
+    else
+    {
+        std::ofstream file(output);
+        write_json(file, results, scale, seed, runs);
+    }
+
+    return 0;
+}
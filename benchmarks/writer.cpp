@@ -23,6 +23,7 @@
 
 #include <chrono>
 #include <iostream>
+#include <vector>
 
 #include <helpers/timing.hpp>
 #include <xyxlnt/xyxlnt.hpp>
@@ -56,6 +57,26 @@ void writer(int cols, int rows)
     wb.save(filename);
 }
 
+// Same as writer, but fills the whole sheet from a contiguous row-major array in one call.
+void block_writer(int cols, int rows)
+{
+    xyxlnt::workbook wb;
+    auto ws = wb.create_sheet();
+
+    std::vector<double> values(static_cast<std::size_t>(cols) * static_cast<std::size_t>(rows));
+
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        values[i] = static_cast<double>(i % static_cast<std::size_t>(cols));
+    }
+
+    ws.write_block(xyxlnt::cell_reference(1, 1), static_cast<std::size_t>(rows),
+        static_cast<std::size_t>(cols), values.data());
+
+    auto filename = "benchmark.xlsx";
+    wb.save(filename);
+}
+
 // Create a timeit call to a function and pass in keyword arguments.
 // The function is called twice, once using the standard workbook, then with the optimised one.
 // Time from the best of three is taken.
@@ -86,5 +107,12 @@ int main()
     timer(&writer, 10, 1000);
     timer(&writer, 1, 10000);
 
+    std::cout << "write_block" << '\n';
+    timer(&block_writer, 10000, 1);
+    timer(&block_writer, 1000, 10);
+    timer(&block_writer, 100, 100);
+    timer(&block_writer, 10, 1000);
+    timer(&block_writer, 1, 10000);
+
     return 0;
 }
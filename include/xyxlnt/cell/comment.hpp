@@ -30,6 +30,12 @@
 
 namespace xyxlnt {
 
+namespace detail {
+
+class memory_meter;
+
+} // namespace detail
+
 /// <summary>
 /// A comment can be applied to a cell to provide extra information about its contents.
 /// </summary>
@@ -122,6 +128,8 @@ public:
     bool operator!=(const comment &other) const;
 
 private:
+    friend class detail::memory_meter;
+
     /// <summary>
     /// The formatted textual content in this cell displayed directly after the author.
     /// </summary>
@@ -33,6 +33,12 @@
 
 namespace xyxlnt {
 
+namespace detail {
+
+class memory_meter;
+
+} // namespace detail
+
 /// <summary>
 /// Encapsulates zero or more formatted text runs where a text run
 /// is a string of text with the same defined formatting.
@@ -152,6 +158,9 @@ public:
     bool operator!=(const std::string &rhs) const;
 
 private:
+    friend class rich_text_hash;
+    friend class detail::memory_meter;
+
     /// <summary>
     /// The runs that make up this rich text.
     /// </summary>
@@ -160,20 +169,22 @@ private:
     optional<phonetic_pr> phonetic_properties_;
 };
 
+/// <summary>
+/// Hashes rich text by the text and font of each run in order, so texts made of the
+/// same runs in a different order or with different formatting hash differently.
+/// </summary>
 class XYXLNT_API rich_text_hash
 {
 public:
-    std::size_t operator()(const rich_text &k) const
-    {
-        std::size_t res = 0;
-
-        for (auto r : k.runs())
-        {
-            res ^= std::hash<std::string>()(r.first);
-        }
+    /// <summary>
+    /// Returns the hash of k.
+    /// </summary>
+    std::size_t operator()(const rich_text &k) const;
 
-        return res;
-    }
+    /// <summary>
+    /// Returns the hash rich_text(plain_text) would have without constructing it.
+    /// </summary>
+    std::size_t operator()(const std::string &plain_text) const;
 };
 
 } // namespace xyxlnt
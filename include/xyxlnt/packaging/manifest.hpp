@@ -33,6 +33,12 @@
 
 namespace xyxlnt {
 
+namespace detail {
+
+class memory_meter;
+
+} // namespace detail
+
 /// <summary>
 /// The manifest keeps track of all files in the OOXML package and
 /// their type and relationships.
@@ -175,6 +181,8 @@ public:
     bool operator==(const manifest &other) const;
 
 private:
+    friend class detail::memory_meter;
+
     /// <summary>
     /// Returns the lowest rId for the given part that hasn't already been registered.
     /// </summary>
@@ -37,6 +37,7 @@ class fill;
 class font;
 class number_format;
 class protection;
+class range;
 class style;
 
 template <typename T>
@@ -220,6 +221,7 @@ private:
     friend class detail::xlsx_producer;
     friend class detail::xlsx_consumer;
     friend class cell;
+    friend class range;
 
     /// <summary>
     /// Constructs a format from an impl pointer.
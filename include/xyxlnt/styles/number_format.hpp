@@ -25,6 +25,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include <xyxlnt/xyxlnt_config.hpp>
@@ -34,6 +35,12 @@ namespace xyxlnt {
 
 enum class calendar;
 
+namespace detail {
+
+class number_format_cache;
+
+} // namespace detail
+
 /// <summary>
 /// Describes the number formatting applied to text and numbers within a certain cell.
 /// </summary>
@@ -269,6 +276,11 @@ private:
     /// The format code
     /// </summary>
     std::string format_string_;
+
+    /// <summary>
+    /// The parsed format code, shared by copies of this format and filled on first use
+    /// </summary>
+    std::shared_ptr<detail::number_format_cache> cache_;
 };
 
 } // namespace xyxlnt
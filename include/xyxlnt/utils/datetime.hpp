@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #include <xyxlnt/xyxlnt_config.hpp>
@@ -56,6 +57,13 @@ struct XYXLNT_API datetime
     /// </summary>
     static datetime from_number(double number, calendar base_date);
 
+    /// <summary>
+    /// Converts the count numbers starting at numbers as from_number would and assigns
+    /// the results to the count datetimes starting at result. This avoids a call per
+    /// value when reading a column of timestamps.
+    /// </summary>
+    static void from_numbers(const double *numbers, std::size_t count, calendar base_date, datetime *result);
+
     /// <summary>
     /// Returns a datetime equivalent to the ISO-formatted string iso_string.
     /// </summary>
@@ -86,6 +94,12 @@ struct XYXLNT_API datetime
     /// </summary>
     double to_number(calendar base_date) const;
 
+    /// <summary>
+    /// Converts the count datetimes starting at datetimes as to_number would and writes
+    /// the results to the count doubles starting at result.
+    /// </summary>
+    static void to_numbers(const datetime *datetimes, std::size_t count, calendar base_date, double *result);
+
     /// <summary>
     /// Returns true if this datetime is equivalent to comparand.
     /// </summary>
@@ -28,6 +28,8 @@
 #include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <sstream>
 #include <type_traits>
@@ -131,6 +133,186 @@ class number_serialiser
         }
     }
 
+    static char *write_digits(std::uint64_t value, char *out)
+    {
+        char digits[20];
+        char *end = digits + sizeof(digits);
+        char *first = end;
+
+        do
+        {
+            *--first = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+
+        return std::copy(first, end, out);
+    }
+
+    // Writes d as snprintf("%.15g") would into buf without going through the C library.
+    // Returns the length written or 0 if d is outside the range handled here (zero,
+    // subnormals, non-finite values and magnitudes beyond 1e-8..1e36) or int128 is
+    // not available. The 15 significant digits are computed exactly with 128-bit
+    // integers and ties are rounded to even, as glibc does.
+    static std::size_t serialise_fast(double d, char *buf)
+    {
+#if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 uint128;
+
+        static const std::uint64_t pow10_15 = 1000000000000000ULL;
+        static const std::uint64_t pow10_14 = 100000000000000ULL;
+
+        std::uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+
+        const auto biased_exponent = static_cast<int>((bits >> 52) & 0x7ff);
+        if (biased_exponent == 0 || biased_exponent == 0x7ff) return 0;
+
+        // d = +/- mantissa * 2^binary_exponent
+        const std::uint64_t mantissa = (bits & ((1ULL << 52) - 1)) | (1ULL << 52);
+        const int binary_exponent = biased_exponent - 1075;
+        if (binary_exponent > 70 || binary_exponent < -126) return 0;
+
+        char *out = buf;
+
+        if (bits >> 63)
+        {
+            *out++ = '-';
+        }
+
+        // integers below 10^15 have at most 15 digits and are printed exactly
+        if (binary_exponent < 0 && binary_exponent > -53
+            && (mantissa & ((1ULL << -binary_exponent) - 1)) == 0
+            && (mantissa >> -binary_exponent) < pow10_15)
+        {
+            return static_cast<std::size_t>(write_digits(mantissa >> -binary_exponent, out) - buf);
+        }
+
+        // decimal exponent of the leading digit, possibly one too low
+        int decimal_exponent = static_cast<int>(std::floor((biased_exponent - 1023) * 0.30102999566398119521));
+        uint128 quotient = 0;
+        uint128 remainder = 0;
+        uint128 divisor = 1;
+
+        for (int attempt = 0; attempt < 2; ++attempt)
+        {
+            // quotient = floor(|d| * 10^scale), which has 15 digits once decimal_exponent is right
+            const int scale = 14 - decimal_exponent;
+            if (scale > 22 || scale < -23) return 0;
+
+            uint128 numerator = mantissa;
+            uint128 power = 1;
+            for (int i = 0; i < (scale < 0 ? -scale : scale); ++i)
+            {
+                power *= 10;
+            }
+
+            if (scale >= 0)
+            {
+                numerator *= power;
+            }
+
+            if (binary_exponent >= 0)
+            {
+                numerator <<= binary_exponent;
+            }
+
+            if (scale < 0)
+            {
+                divisor = power << (binary_exponent < 0 ? -binary_exponent : 0);
+                quotient = numerator / divisor;
+                remainder = numerator % divisor;
+            }
+            else
+            {
+                const int shift = binary_exponent < 0 ? -binary_exponent : 0;
+                divisor = uint128(1) << shift;
+                quotient = numerator >> shift;
+                remainder = numerator & (divisor - 1);
+            }
+
+            if (quotient < pow10_14)
+            {
+                --decimal_exponent;
+            }
+            else if (quotient >= pow10_15)
+            {
+                ++decimal_exponent;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        if (quotient < pow10_14 || quotient >= pow10_15) return 0;
+
+        auto significand = static_cast<std::uint64_t>(quotient);
+        const auto rest = divisor - remainder;
+
+        if (remainder > rest || (remainder == rest && (significand & 1) != 0))
+        {
+            if (++significand == pow10_15)
+            {
+                significand = pow10_14;
+                ++decimal_exponent;
+            }
+        }
+
+        char digits[15];
+        write_digits(significand, digits);
+        int length = 15;
+        while (length > 1 && digits[length - 1] == '0')
+        {
+            --length;
+        }
+
+        if (decimal_exponent < -4 || decimal_exponent >= 15)
+        {
+            *out++ = digits[0];
+
+            if (length > 1)
+            {
+                *out++ = '.';
+                out = std::copy(digits + 1, digits + length, out);
+            }
+
+            *out++ = 'e';
+            *out++ = decimal_exponent < 0 ? '-' : '+';
+            const auto magnitude = static_cast<std::uint64_t>(decimal_exponent < 0 ? -decimal_exponent : decimal_exponent);
+            if (magnitude < 10)
+            {
+                *out++ = '0';
+            }
+            out = write_digits(magnitude, out);
+        }
+        else if (decimal_exponent >= 0)
+        {
+            const int integer_digits = decimal_exponent + 1;
+            out = std::copy(digits, digits + std::min(length, integer_digits), out);
+            out = std::fill_n(out, std::max(0, integer_digits - length), '0');
+
+            if (length > integer_digits)
+            {
+                *out++ = '.';
+                out = std::copy(digits + integer_digits, digits + length, out);
+            }
+        }
+        else
+        {
+            *out++ = '0';
+            *out++ = '.';
+            out = std::fill_n(out, -decimal_exponent - 1, '0');
+            out = std::copy(digits, digits + length, out);
+        }
+
+        return static_cast<std::size_t>(out - buf);
+#else
+        (void)d;
+        (void)buf;
+        return 0;
+#endif
+    }
+
 public:
     explicit number_serialiser()
         : should_convert_comma(localeconv()->decimal_point[0] == ',')
@@ -141,13 +323,28 @@ public:
     // This matches the output format of excel irrespective of current locale
     std::string serialise(double d) const
     {
-        char buf[30];
-        int len = snprintf(buf, sizeof(buf), "%.15g", d);
+        char buf[32];
+        return std::string(buf, serialise(d, buf, sizeof(buf)));
+    }
+
+    // as serialise, writing into buf instead of allocating. buf should hold at least
+    // 32 characters; the result is truncated to fit size - 1 otherwise.
+    std::size_t serialise(double d, char *buf, std::size_t size) const
+    {
+        if (size >= 32)
+        {
+            auto len = serialise_fast(d, buf);
+            if (len > 0) return len;
+        }
+
+        int written = snprintf(buf, size, "%.15g", d);
+        if (written < 0) written = 0;
+        if (static_cast<std::size_t>(written) >= size) written = static_cast<int>(size - 1);
         if (should_convert_comma)
         {
-            convert_comma_to_pt(buf, len);
+            convert_comma_to_pt(buf, written);
         }
-        return std::string(buf, static_cast<size_t>(len));
+        return static_cast<std::size_t>(written);
     }
 
     // replacement for std::to_string / s*printf("%f", ...)
@@ -163,6 +360,20 @@ public:
         return std::string(buf, static_cast<size_t>(len));
     }
 
+    // as serialise_short, writing into buf instead of allocating.
+    // Returns the number of characters written, which is truncated to fit size - 1.
+    std::size_t serialise_short(double d, char *buf, std::size_t size) const
+    {
+        int len = snprintf(buf, size, "%f", d);
+        if (len < 0) len = 0;
+        if (static_cast<std::size_t>(len) >= size) len = static_cast<int>(size - 1);
+        if (should_convert_comma)
+        {
+            convert_comma_to_pt(buf, len);
+        }
+        return static_cast<std::size_t>(len);
+    }
+
     double deserialise(const std::string &s, ptrdiff_t *len_converted) const
     {
         assert(!s.empty());
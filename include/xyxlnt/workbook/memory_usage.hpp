@@ -0,0 +1,81 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+
+#include <xyxlnt/xyxlnt_config.hpp>
+
+namespace xyxlnt {
+
+/// <summary>
+/// The heap memory held by a workbook or worksheet, in bytes, broken down by what it
+/// stores. Returned by workbook::memory_usage and worksheet::memory_usage.
+/// </summary>
+class XYXLNT_API memory_usage
+{
+public:
+    /// <summary>
+    /// The memory the cells are allocated from, including space freed by deleted cells
+    /// and kept for new ones, plus the text, formulas and hyperlinks they own.
+    /// </summary>
+    std::size_t cells = 0;
+
+    /// <summary>
+    /// The shared string table, its lookup index and reference counts.
+    /// </summary>
+    std::size_t shared_strings = 0;
+
+    /// <summary>
+    /// The stylesheet: formats, styles and their components.
+    /// </summary>
+    std::size_t styles = 0;
+
+    /// <summary>
+    /// Embedded images, the thumbnail and other binary parts kept as-is.
+    /// </summary>
+    std::size_t images_and_binaries = 0;
+
+    /// <summary>
+    /// Cell comments.
+    /// </summary>
+    std::size_t comments = 0;
+
+    /// <summary>
+    /// Content types and relationships of the package.
+    /// </summary>
+    std::size_t manifest = 0;
+
+    /// <summary>
+    /// Returns the sum of all categories.
+    /// </summary>
+    std::size_t total() const;
+
+    /// <summary>
+    /// Adds each category of other to this one.
+    /// </summary>
+    memory_usage &operator+=(const memory_usage &other);
+};
+
+} // namespace xyxlnt
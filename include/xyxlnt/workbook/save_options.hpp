@@ -0,0 +1,67 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+
+#include <xyxlnt/xyxlnt_config.hpp>
+
+namespace xyxlnt {
+
+class serialization_profile;
+
+/// <summary>
+/// Settings that change how workbook::save produces a file without changing what is
+/// in it.
+/// </summary>
+class XYXLNT_API save_options
+{
+public:
+    /// <summary>
+    /// The number of threads used to serialize and compress worksheets, including their
+    /// comments and drawings. With 1, every part is written on the calling thread. With
+    /// more, worksheets are rendered concurrently into memory and the finished parts are
+    /// added to the archive in relationship order, producing the same file. 0 uses
+    /// std::thread::hardware_concurrency(). The workbook must not be modified by any
+    /// thread while it's being saved.
+    /// </summary>
+    std::size_t worksheet_threads = 1;
+
+    /// <summary>
+    /// If true, the shared string table is rewritten to hold only the strings some cell
+    /// uses, with duplicates merged, in the order they're first used going through the
+    /// worksheets row by row. Cells are written with the new indices. The workbook itself
+    /// isn't changed. This shrinks files that were loaded and heavily edited, and the
+    /// ordering helps compression.
+    /// </summary>
+    bool compact_shared_strings = false;
+
+    /// <summary>
+    /// If set, the time and data spent on each part of the file is recorded here,
+    /// replacing what it held. Nothing is measured otherwise.
+    /// </summary>
+    serialization_profile *profile = nullptr;
+};
+
+} // namespace xyxlnt
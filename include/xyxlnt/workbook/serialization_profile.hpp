@@ -0,0 +1,92 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <xyxlnt/xyxlnt_config.hpp>
+#include <xyxlnt/utils/path.hpp>
+
+namespace xyxlnt {
+
+/// <summary>
+/// What was measured while one part of an XLSX package was read or written.
+/// </summary>
+class XYXLNT_API part_profile
+{
+public:
+    /// <summary>
+    /// The path of the part in the package.
+    /// </summary>
+    path part;
+
+    /// <summary>
+    /// The wall time spent on this part, not counting other parts read or written while
+    /// it was open, such as worksheets while the workbook part is read.
+    /// </summary>
+    std::chrono::nanoseconds duration = std::chrono::nanoseconds::zero();
+
+    /// <summary>
+    /// The share of duration spent decompressing or compressing the part. The rest went
+    /// into parsing or serializing it and building or reading the workbook.
+    /// </summary>
+    std::chrono::nanoseconds compression_duration = std::chrono::nanoseconds::zero();
+
+    /// <summary>
+    /// The size of the part.
+    /// </summary>
+    std::uint64_t uncompressed_bytes = 0;
+
+    /// <summary>
+    /// The size of the part in the ZIP archive.
+    /// </summary>
+    std::uint64_t compressed_bytes = 0;
+
+    /// <summary>
+    /// The number of cells read from or written into a worksheet part.
+    /// </summary>
+    std::uint64_t cells = 0;
+};
+
+/// <summary>
+/// Timings and counters collected by workbook::load and workbook::save when
+/// load_options::profile or save_options::profile points to one.
+/// </summary>
+class XYXLNT_API serialization_profile
+{
+public:
+    /// <summary>
+    /// Each part in the order it was begun.
+    /// </summary>
+    std::vector<part_profile> parts;
+
+    /// <summary>
+    /// The wall time of the whole load or save.
+    /// </summary>
+    std::chrono::nanoseconds duration = std::chrono::nanoseconds::zero();
+};
+
+} // namespace xyxlnt
@@ -45,7 +45,11 @@ class xlsx_producer;
 } // namespace detail
 
 /// <summary>
-/// workbook is the container for all other parts of the document.
+/// Writes an XLSX file cell by cell without keeping the cells in memory. Cells must be
+/// added in row-major order and each one is serialized into the open worksheet part when
+/// the next one is added. Strings are written inline rather than to the shared string
+/// table, so memory use doesn't grow with the number of rows. Hyperlinks and comments
+/// set on streamed cells are not written.
 /// </summary>
 class XYXLNT_API streaming_workbook_writer
 {
@@ -63,13 +67,18 @@ public:
     /// <summary>
     /// Writes a cell to the currently active worksheet at the position given by
     /// ref and with the given value. ref should be to the right of or below
-    /// the previously written cell.
+    /// the previously written cell, otherwise invalid_parameter is thrown.
+    /// The returned cell is reused for every call, so it should be given its
+    /// value and format before the next cell is added.
     /// </summary>
     cell add_cell(const cell_reference &ref);
 
     /// <summary>
     /// Ends writing of data to the current sheet and begins writing a new sheet
-    /// with the given title.
+    /// with the given title. The first call names the workbook's initial sheet
+    /// unless cells were already added to it. Sheet properties that Excel stores
+    /// ahead of the cells, such as views and column widths, must be set before
+    /// the first cell of the sheet is added.
     /// </summary>
     worksheet add_worksheet(const std::string &title);
 
@@ -54,7 +54,9 @@ class fill;
 class font;
 class format;
 class rich_text;
+class load_options;
 class manifest;
+class memory_usage;
 class metadata_property;
 class named_range;
 class number_format;
@@ -64,6 +66,7 @@ class protection;
 class range;
 class range_reference;
 class relationship;
+class save_options;
 class streaming_workbook_reader;
 class style;
 class style_serializer;
@@ -78,6 +81,7 @@ struct datetime;
 
 namespace detail {
 
+struct cell_impl;
 struct stylesheet;
 struct workbook_impl;
 class xlsx_consumer;
@@ -480,6 +484,12 @@ public:
     /// </summary>
     void save(std::vector<std::uint8_t> &data, const std::string &password) const;
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file using the given options and saves the
+    /// bytes into byte vector data.
+    /// </summary>
+    void save(std::vector<std::uint8_t> &data, const save_options &options) const;
+
     /// <summary>
     /// Serializes the workbook into an XLSX file and saves the data into a file
     /// named filename.
@@ -492,6 +502,12 @@ public:
     /// </summary>
     void save(const std::string &filename, const std::string &password) const;
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file using the given options and saves the
+    /// data into a file named filename.
+    /// </summary>
+    void save(const std::string &filename, const save_options &options) const;
+
 #ifdef _MSC_VER
     /// <summary>
     /// Serializes the workbook into an XLSX file and saves the data into a file
@@ -504,6 +520,12 @@ public:
     /// and loads the bytes into a file named filename.
     /// </summary>
     void save(const std::wstring &filename, const std::string &password) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file using the given options and saves the
+    /// data into a file named filename.
+    /// </summary>
+    void save(const std::wstring &filename, const save_options &options) const;
 #endif
 
     /// <summary>
@@ -518,6 +540,12 @@ public:
     /// </summary>
     void save(const xyxlnt::path &filename, const std::string &password) const;
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file using the given options and saves the
+    /// data into a file named filename.
+    /// </summary>
+    void save(const xyxlnt::path &filename, const save_options &options) const;
+
     /// <summary>
     /// Serializes the workbook into an XLSX file and saves the data into stream.
     /// </summary>
@@ -529,6 +557,12 @@ public:
     /// </summary>
     void save(std::ostream &stream, const std::string &password) const;
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file using the given options and saves the
+    /// data into stream.
+    /// </summary>
+    void save(std::ostream &stream, const save_options &options) const;
+
     /// <summary>
     /// Interprets byte vector data as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -541,6 +575,12 @@ public:
     /// </summary>
     void load(const std::vector<std::uint8_t> &data, const std::string &password);
 
+    /// <summary>
+    /// Interprets byte vector data as an XLSX file using the given options and sets the
+    /// content of this workbook to match that file.
+    /// </summary>
+    void load(const std::vector<std::uint8_t> &data, const load_options &options);
+
     /// <summary>
     /// Interprets file with the given filename as an XLSX file and sets
     /// the content of this workbook to match that file.
@@ -553,6 +593,12 @@ public:
     /// </summary>
     void load(const std::string &filename, const std::string &password);
 
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file using the given options
+    /// and sets the content of this workbook to match that file.
+    /// </summary>
+    void load(const std::string &filename, const load_options &options);
+
 #ifdef _MSC_VER
     /// <summary>
     /// Interprets file with the given filename as an XLSX file and sets
@@ -565,6 +611,12 @@ public:
     /// given password and sets the content of this workbook to match that file.
     /// </summary>
     void load(const std::wstring &filename, const std::string &password);
+
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file using the given options
+    /// and sets the content of this workbook to match that file.
+    /// </summary>
+    void load(const std::wstring &filename, const load_options &options);
 #endif
 
     /// <summary>
@@ -579,6 +631,12 @@ public:
     /// </summary>
     void load(const xyxlnt::path &filename, const std::string &password);
 
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file using the given options
+    /// and sets the content of this workbook to match that file.
+    /// </summary>
+    void load(const xyxlnt::path &filename, const load_options &options);
+
     /// <summary>
     /// Interprets data in stream as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -591,6 +649,12 @@ public:
     /// </summary>
     void load(std::istream &stream, const std::string &password);
 
+    /// <summary>
+    /// Interprets data in stream as an XLSX file using the given options and sets the
+    /// content of this workbook to match that file.
+    /// </summary>
+    void load(std::istream &stream, const load_options &options);
+
     // View
 
     /// <summary>
@@ -773,6 +837,14 @@ public:
     /// </summary>
     std::size_t add_shared_string(const rich_text &shared, bool allow_duplicates = false);
 
+    /// <summary>
+    /// Append an unformatted shared string to the shared string collection in this
+    /// workbook, reusing an equal existing string. This is equivalent to
+    /// add_shared_string(rich_text(shared)) but only constructs the rich_text when the
+    /// string is new. Returns the index of the string.
+    /// </summary>
+    std::size_t add_shared_string(const std::string &shared);
+
     /// <summary>
     /// Returns a reference to the shared string related to the specified index
     /// </summary>
@@ -826,6 +898,14 @@ public:
     /// </summary>
     void calculation_properties(const class calculation_properties &props);
 
+    // Memory
+
+    /// <summary>
+    /// Returns the heap memory held by this workbook, including all of its worksheets,
+    /// broken down by what it stores.
+    /// </summary>
+    class memory_usage memory_usage() const;
+
     // Operators
 
     /// <summary>
@@ -859,6 +939,7 @@ public:
 private:
     friend class streaming_workbook_reader;
     friend class worksheet;
+    friend struct detail::cell_impl;
     friend class detail::xlsx_consumer;
     friend class detail::xlsx_producer;
 
@@ -35,6 +35,7 @@
 #include <xyxlnt/styles/conditional_format.hpp>
 #include <xyxlnt/styles/fill.hpp>
 #include <xyxlnt/styles/font.hpp>
+#include <xyxlnt/styles/format.hpp>
 #include <xyxlnt/styles/number_format.hpp>
 #include <xyxlnt/styles/protection.hpp>
 #include <xyxlnt/worksheet/cell_vector.hpp>
@@ -48,6 +49,12 @@ namespace xyxlnt {
 class const_range_iterator;
 class range_iterator;
 
+namespace detail {
+
+struct format_impl;
+
+} // namespace detail
+
 /// <summary>
 /// A range is a 2D collection of cells with defined extens that can be iterated upon.
 /// </summary>
@@ -168,6 +175,13 @@ public:
     /// </summary>
     range protection(const xyxlnt::protection &new_protection);
 
+    /// <summary>
+    /// Sets the format of all cells in the range to new_format and returns the range.
+    /// This replaces any alignment, border, fill, font, number format, protection and
+    /// style previously applied to those cells.
+    /// </summary>
+    range apply_format(const xyxlnt::format &new_format);
+
     /// <summary>
     /// Sets the named style applied to all cells in this range to a style named style_name.
     /// </summary>
@@ -291,6 +305,12 @@ public:
     bool operator!=(const range &comparand) const;
 
 private:
+    /// <summary>
+    /// Replaces the format of each cell in the range with a copy of it changed by modify.
+    /// modify is called once per distinct format rather than once per cell.
+    /// </summary>
+    void restyle(const std::function<void(detail::format_impl &)> &modify);
+
     /// <summary>
     /// The worksheet this range is within
     /// </summary>
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -31,8 +32,10 @@
 #include <vector>
 
 #include <xyxlnt/xyxlnt_config.hpp>
+#include <xyxlnt/cell/cell_type.hpp>
 #include <xyxlnt/cell/index_types.hpp>
 #include <xyxlnt/packaging/relationship.hpp>
+#include <xyxlnt/worksheet/major_order.hpp>
 #include <xyxlnt/worksheet/page_margins.hpp>
 #include <xyxlnt/worksheet/page_setup.hpp>
 #include <xyxlnt/worksheet/sheet_view.hpp>
@@ -49,12 +52,14 @@ class conditional_format;
 class const_range_iterator;
 class footer;
 class header;
+class memory_usage;
 class range;
 class range_iterator;
 class range_reference;
 class relationship;
 class row_properties;
 class sheet_format_properties;
+class variant;
 class workbook;
 class phonetic_pr;
 
@@ -254,6 +259,54 @@ public:
     /// </summary>
     const class range columns(bool skip_null = true) const;
 
+    /// <summary>
+    /// Sets the values of the rows x columns block of cells whose top-left corner is
+    /// top_left from the row-major array values. row_stride is the number of elements
+    /// between the starts of consecutive rows in values and defaults to columns when 0.
+    /// Cells are created as needed, and existing formats are kept.
+    /// </summary>
+    void write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns,
+        const double *values, std::size_t row_stride = 0);
+
+    /// <summary>
+    /// Sets the values of the rows x columns block of cells whose top-left corner is
+    /// top_left from the row-major array values, storing each as a shared string.
+    /// row_stride is the number of elements between the starts of consecutive rows
+    /// in values and defaults to columns when 0.
+    /// </summary>
+    void write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns,
+        const std::string *values, std::size_t row_stride = 0);
+
+    /// <summary>
+    /// Sets the values of the rows x columns block of cells whose top-left corner is
+    /// top_left from the row-major array values. Null variants clear the cell; integer,
+    /// string, boolean and date variants are stored as by cell::value. row_stride is the
+    /// number of elements between the starts of consecutive rows in values and defaults
+    /// to columns when 0. Vector variants cause an invalid_parameter exception.
+    /// </summary>
+    void write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns,
+        const variant *values, std::size_t row_stride = 0);
+
+    /// <summary>
+    /// Copies the numeric values of the cells in block into values, which must hold
+    /// block.width() * block.height() elements laid out in the given order. Numbers,
+    /// dates and booleans are copied as numbers; any other cell, including one that
+    /// doesn't exist, is written as a quiet NaN. If types isn't null, it receives the
+    /// type of each cell in the same layout, with missing cells reported as empty.
+    /// </summary>
+    void read_block(const range_reference &block, double *values, cell_type *types = nullptr,
+        major_order order = major_order::row) const;
+
+    /// <summary>
+    /// Copies the plain text of the cells in block into values, which must hold
+    /// block.width() * block.height() elements laid out in the given order. Cells
+    /// without string values, including ones that don't exist, are written as empty
+    /// strings. If types isn't null, it receives the type of each cell in the same
+    /// layout, with missing cells reported as empty.
+    /// </summary>
+    void read_block(const range_reference &block, std::string *values, cell_type *types = nullptr,
+        major_order order = major_order::row) const;
+
     //TODO: finish implementing cell_iterator wrapping before uncommenting
     //class cell_vector cells(bool skip_null = true);
 
@@ -271,22 +324,26 @@ public:
     void clear_row(row_t row);
 
     /// <summary>
-    /// Insert empty rows before the given row index
+    /// Insert empty rows before the given row index. Cell formulae, comments,
+    /// hyperlinks and merged ranges referring to moved cells are updated.
     /// </summary>
     void insert_rows(row_t row, std::uint32_t amount);
 
     /// <summary>
-    /// Insert empty columns before the given column index
+    /// Insert empty columns before the given column index. Cell formulae, comments,
+    /// hyperlinks and merged ranges referring to moved cells are updated.
     /// </summary>
     void insert_columns(column_t column, std::uint32_t amount);
 
     /// <summary>
-    /// Delete rows before the given row index
+    /// Delete rows before the given row index. Formula references to deleted
+    /// cells become #REF!.
     /// </summary>
     void delete_rows(row_t row, std::uint32_t amount);
 
     /// <summary>
-    /// Delete columns before the given column index
+    /// Delete columns before the given column index. Formula references to deleted
+    /// cells become #REF!.
     /// </summary>
     void delete_columns(column_t column, std::uint32_t amount);
 
@@ -443,11 +500,13 @@ public:
 
     /// <summary>
     /// Merges the cells within the range represented by the given string.
+    /// An invalid_parameter exception will be thrown if the range overlaps an existing merged range.
     /// </summary>
     void merge_cells(const std::string &reference_string);
 
     /// <summary>
     /// Merges the cells within the given range.
+    /// An invalid_parameter exception will be thrown if the range overlaps an existing merged range.
     /// </summary>
     void merge_cells(const range_reference &reference);
 
@@ -462,10 +521,16 @@ public:
     void unmerge_cells(const range_reference &reference);
 
     /// <summary>
-    /// Returns a vector of references of all merged ranges in the worksheet.
+    /// Returns a vector of references of all merged ranges in the worksheet
+    /// ordered by their top-left cell.
     /// </summary>
     std::vector<range_reference> merged_ranges() const;
 
+    /// <summary>
+    /// Returns the merged range containing the cell at the given reference if there is one.
+    /// </summary>
+    optional<range_reference> merged_range(const cell_reference &reference) const;
+
     // operators
 
     /// <summary>
@@ -574,11 +639,18 @@ public:
     bool has_auto_filter() const;
 
     /// <summary>
-    /// Reserve n rows. This can be optionally called before adding many rows
-    /// to improve performance.
+    /// Reserve n rows. Cells are stored in ordered rows, so this is kept for
+    /// compatibility and has no effect.
     /// </summary>
     void reserve(std::size_t n);
 
+    /// <summary>
+    /// Returns the heap memory held by the cells and comments of this sheet. Shared
+    /// strings, styles and the other workbook-level storage are counted only by
+    /// workbook::memory_usage.
+    /// </summary>
+    class memory_usage memory_usage() const;
+
     /// <summary>
     /// Returns true if this sheet has phonetic properties
     /// </summary>
@@ -796,6 +868,7 @@ public:
 private:
     friend class cell;
     friend class const_range_iterator;
+    friend class range;
     friend class range_iterator;
     friend class workbook;
     friend class detail::xlsx_consumer;
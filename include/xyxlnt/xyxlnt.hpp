@@ -64,8 +64,12 @@
 // workbook
 #include <xyxlnt/workbook/document_security.hpp>
 #include <xyxlnt/workbook/external_book.hpp>
+#include <xyxlnt/workbook/load_options.hpp>
+#include <xyxlnt/workbook/memory_usage.hpp>
 #include <xyxlnt/workbook/metadata_property.hpp>
 #include <xyxlnt/workbook/named_range.hpp>
+#include <xyxlnt/workbook/save_options.hpp>
+#include <xyxlnt/workbook/serialization_profile.hpp>
 #include <xyxlnt/workbook/streaming_workbook_reader.hpp>
 #include <xyxlnt/workbook/streaming_workbook_writer.hpp>
 #include <xyxlnt/workbook/theme.hpp>
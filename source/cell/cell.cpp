@@ -56,6 +56,7 @@
 #include <detail/implementations/format_impl.hpp>
 #include <detail/implementations/hyperlink_impl.hpp>
 #include <detail/implementations/stylesheet.hpp>
+#include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <xyxlnt/utils/numeric.hpp>
 
@@ -148,6 +149,15 @@ std::pair<bool, xyxlnt::time> cast_time(const std::string &s)
     return {true, result};
 }
 
+// Lets the worksheet know that this cell may be removed by the next garbage collection.
+void mark_if_collectible(xyxlnt::detail::cell_impl *d)
+{
+    if (d->is_garbage_collectible())
+    {
+        d->parent_->mark_garbage_candidate(d->column_, d->row());
+    }
+}
+
 } // namespace
 
 namespace xyxlnt {
@@ -208,57 +218,63 @@ void cell::value(std::nullptr_t)
 
 void cell::value(bool boolean_value)
 {
+    d_->release_shared_string();
     d_->type_ = type::boolean;
     d_->value_numeric_ = boolean_value ? 1.0 : 0.0;
 }
 
 void cell::value(int int_value)
 {
+    d_->release_shared_string();
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(unsigned int int_value)
 {
+    d_->release_shared_string();
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(long long int int_value)
 {
+    d_->release_shared_string();
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(unsigned long long int int_value)
 {
+    d_->release_shared_string();
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(float float_value)
 {
+    d_->release_shared_string();
     d_->value_numeric_ = static_cast<double>(float_value);
     d_->type_ = type::number;
 }
 
 void cell::value(double float_value)
 {
+    d_->release_shared_string();
     d_->value_numeric_ = static_cast<double>(float_value);
     d_->type_ = type::number;
 }
 
 void cell::value(const std::string &s)
 {
-    value(rich_text(check_string(s)));
+    d_->assign_shared_string(workbook().add_shared_string(check_string(s)));
 }
 
 void cell::value(const rich_text &text)
 {
     check_string(text.plain_text());
 
-    d_->type_ = type::shared_string;
-    d_->value_numeric_ = static_cast<double>(workbook().add_shared_string(text));
+    d_->assign_shared_string(workbook().add_shared_string(text));
 }
 
 void cell::value(const char *c)
@@ -268,16 +284,30 @@ void cell::value(const char *c)
 
 void cell::value(const cell c)
 {
+    d_->release_shared_string();
+
     d_->type_ = c.d_->type_;
     d_->value_numeric_ = c.d_->value_numeric_;
     d_->value_text_ = c.d_->value_text_;
     d_->hyperlink_ = c.d_->hyperlink_;
     d_->formula_ = c.d_->formula_;
     d_->format_ = c.d_->format_;
+    d_->update_cell_references();
+
+    if (d_->type_ == type::shared_string)
+    {
+        if (auto workbook = d_->parent_workbook())
+        {
+            workbook->reference_shared_string(static_cast<std::size_t>(d_->value_numeric_));
+        }
+    }
+
+    mark_if_collectible(d_);
 }
 
 void cell::value(const date &d)
 {
+    d_->release_shared_string();
     d_->type_ = type::number;
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_yyyymmdd2());
@@ -285,6 +315,7 @@ void cell::value(const date &d)
 
 void cell::value(const datetime &d)
 {
+    d_->release_shared_string();
     d_->type_ = type::number;
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_datetime());
@@ -292,6 +323,7 @@ void cell::value(const datetime &d)
 
 void cell::value(const time &t)
 {
+    d_->release_shared_string();
     d_->type_ = type::number;
     d_->value_numeric_ = t.to_number();
     number_format(number_format::date_time6());
@@ -299,6 +331,7 @@ void cell::value(const time &t)
 
 void cell::value(const timedelta &t)
 {
+    d_->release_shared_string();
     d_->type_ = type::number;
     d_->value_numeric_ = t.to_number();
     number_format(xyxlnt::number_format("[hh]:mm:ss"));
@@ -306,7 +339,7 @@ void cell::value(const timedelta &t)
 
 row_t cell::row() const
 {
-    return d_->row_;
+    return d_->row();
 }
 
 column_t cell::column() const
@@ -322,6 +355,11 @@ column_t::index_t cell::column_index() const
 void cell::merged(bool merged)
 {
     d_->is_merged_ = merged;
+
+    if (!merged)
+    {
+        mark_if_collectible(d_);
+    }
 }
 
 bool cell::is_merged() const
@@ -337,6 +375,11 @@ bool cell::phonetics_visible() const
 void cell::show_phonetics(bool phonetics)
 {
     d_->phonetics_visible_ = phonetics;
+
+    if (!phonetics)
+    {
+        mark_if_collectible(d_);
+    }
 }
 
 bool cell::is_date() const
@@ -348,7 +391,7 @@ bool cell::is_date() const
 
 cell_reference cell::reference() const
 {
-    return {d_->column_, d_->row_};
+    return {d_->column_, d_->row()};
 }
 
 bool cell::operator==(const cell &comparand) const
@@ -398,6 +441,7 @@ void cell::hyperlink(const std::string &url, const std::string &display)
         // TODO: make manifest::register_relationship return the created relationship instead of rel id
         d_->hyperlink_.get().relationship = manifest.relationship(ws.path(), rel_id);
     }
+    d_->update_cell_references();
     // if a value is already present, the display string is ignored
     if (has_value())
     {
@@ -418,6 +462,7 @@ void cell::hyperlink(xyxlnt::cell target, const std::string &display)
     d_->hyperlink_ = detail::hyperlink_impl();
     d_->hyperlink_.get().relationship = xyxlnt::relationship("", relationship_type::hyperlink,
         uri(""), uri(cell_address), target_mode::internal);
+    d_->update_cell_references();
     // if a value is already present, the display string is ignored
     if (has_value())
     {
@@ -438,6 +483,7 @@ void cell::hyperlink(xyxlnt::range target, const std::string &display)
     d_->hyperlink_ = detail::hyperlink_impl();
     d_->hyperlink_.get().relationship = xyxlnt::relationship("", relationship_type::hyperlink,
         uri(""), uri(range_address), target_mode::internal);
+    d_->update_cell_references();
 
     // if a value is already present, the display string is ignored
     if (has_value())
@@ -467,6 +513,7 @@ void cell::formula(const std::string &formula)
         d_->formula_ = formula;
     }
 
+    d_->update_cell_references();
     worksheet().register_calc_chain_in_manifest();
 }
 
@@ -485,7 +532,9 @@ void cell::clear_formula()
     if (has_formula())
     {
         d_->formula_.clear();
+        d_->update_cell_references();
         worksheet().garbage_collect_formulae();
+        mark_if_collectible(d_);
     }
 }
 
@@ -505,6 +554,7 @@ void cell::error(const std::string &error)
         throw invalid_data_type();
     }
 
+    d_->release_shared_string();
     d_->value_text_.plain_text(error, false);
     d_->type_ = type::error;
 }
@@ -545,7 +595,7 @@ std::pair<int, int> cell::anchor() const
 
     double top = 0;
 
-    for (row_t row_index = 1; row_index <= d_->row_ - 1; row_index++)
+    for (row_t row_index = 1; row_index <= d_->row() - 1; row_index++)
     {
         top += worksheet().row_height(row_index);
     }
@@ -560,6 +610,15 @@ cell::type cell::data_type() const
 
 void cell::data_type(type t)
 {
+    // the value isn't changed with the type so any string it refers to isn't known
+    if (t != d_->type_ && (t == type::shared_string || d_->type_ == type::shared_string))
+    {
+        if (auto workbook = d_->parent_workbook())
+        {
+            workbook->invalidate_shared_string_references();
+        }
+    }
+
     d_->type_ = t;
 }
 
@@ -595,10 +654,19 @@ protection cell::computed_protection() const
 
 void cell::clear_value()
 {
+    d_->release_shared_string();
     d_->value_numeric_ = 0;
     d_->value_text_.clear();
     d_->type_ = cell::type::empty;
-    clear_formula();
+
+    if (has_formula())
+    {
+        clear_formula();
+    }
+    else
+    {
+        mark_if_collectible(d_);
+    }
 }
 
 template <>
@@ -809,6 +877,7 @@ void cell::value(const std::string &value_string, bool infer_type)
 
     if (percentage.first)
     {
+        d_->release_shared_string();
         d_->value_numeric_ = percentage.second;
         d_->type_ = cell::type::number;
         number_format(xyxlnt::number_format::percentage());
@@ -819,6 +888,7 @@ void cell::value(const std::string &value_string, bool infer_type)
 
         if (time.first)
         {
+            d_->release_shared_string();
             d_->type_ = cell::type::number;
             number_format(number_format::date_time6());
             d_->value_numeric_ = time.second.to_number();
@@ -829,6 +899,7 @@ void cell::value(const std::string &value_string, bool infer_type)
 
             if (numeric.first)
             {
+                d_->release_shared_string();
                 d_->value_numeric_ = numeric.second;
                 d_->type_ = cell::type::number;
             }
@@ -842,6 +913,7 @@ void cell::clear_format()
     {
         format().d_->references -= format().d_->references > 0 ? 1 : 0;
         d_->format_.clear();
+        mark_if_collectible(d_);
     }
 }
 
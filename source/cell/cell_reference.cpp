@@ -29,6 +29,7 @@
 #include <xyxlnt/worksheet/range_reference.hpp>
 
 #include <detail/constants.hpp>
+#include <detail/reference_encoding.hpp>
 
 namespace xyxlnt {
 
@@ -82,23 +83,8 @@ range_reference cell_reference::operator,(const xyxlnt::cell_reference &other) c
 
 std::string cell_reference::to_string() const
 {
-    std::string string_representation;
-
-    if (absolute_column_)
-    {
-        string_representation.append("$");
-    }
-
-    string_representation.append(column_.column_string());
-
-    if (absolute_row_)
-    {
-        string_representation.append("$");
-    }
-
-    string_representation.append(std::to_string(row_));
-
-    return string_representation;
+    char buffer[detail::max_cell_reference_length];
+    return std::string(buffer, detail::encode_cell_reference(*this, buffer));
 }
 
 range_reference cell_reference::to_range() const
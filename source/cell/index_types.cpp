@@ -26,6 +26,7 @@
 #include <xyxlnt/cell/index_types.hpp>
 #include <xyxlnt/utils/exceptions.hpp>
 #include <detail/constants.hpp>
+#include <detail/reference_encoding.hpp>
 
 namespace xyxlnt {
 
@@ -68,25 +69,8 @@ std::string column_t::column_string_from_index(column_t::index_t column_index)
         throw invalid_column_index();
     }
 
-    int temp = static_cast<int>(column_index);
-    std::string column_letter = "";
-
-    while (temp > 0)
-    {
-        int quotient = temp / 26, remainder = temp % 26;
-
-        // check for exact division and borrow if needed
-        if (remainder == 0)
-        {
-            quotient -= 1;
-            remainder = 26;
-        }
-
-        column_letter = std::string(1, char(remainder + 64)) + column_letter;
-        temp = quotient;
-    }
-
-    return column_letter;
+    char letters[7];
+    return std::string(letters, detail::encode_column(column_index, letters));
 }
 
 column_t::column_t()
@@ -21,6 +21,7 @@
 //
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
+#include <functional>
 #include <numeric>
 
 #include <xyxlnt/cell/rich_text.hpp>
@@ -31,6 +32,27 @@ bool has_trailing_whitespace(const std::string &s)
 {
     return !s.empty() && (s.front() == ' ' || s.back() == ' ');
 };
+
+void hash_combine(std::size_t &seed, std::size_t value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// Only needs to agree with font::operator==, so the common distinguishing
+// properties are enough.
+std::size_t hash_run_font(const xyxlnt::optional<xyxlnt::font> &run_font)
+{
+    if (!run_font.is_set()) return 0;
+
+    const auto &f = run_font.get();
+    std::size_t seed = 1;
+
+    hash_combine(seed, f.has_name() ? std::hash<std::string>()(f.name()) : 0);
+    hash_combine(seed, f.has_size() ? std::hash<double>()(f.size()) : 0);
+    hash_combine(seed, (f.bold() ? 1u : 0u) | (f.italic() ? 2u : 0u));
+
+    return seed;
+}
 } // namespace
 
 namespace xyxlnt {
@@ -156,7 +178,12 @@ bool rich_text::operator==(const rich_text &rhs) const
 
 bool rich_text::operator==(const std::string &rhs) const
 {
-    return *this == rich_text(rhs);
+    // same as comparing with rich_text(rhs), without constructing it
+    return runs_.size() == 1
+        && runs_.front().first == rhs
+        && !runs_.front().second.is_set()
+        && phonetic_runs_.empty()
+        && !phonetic_properties_.is_set();
 }
 
 bool rich_text::operator!=(const rich_text &rhs) const
@@ -169,4 +196,30 @@ bool rich_text::operator!=(const std::string &rhs) const
     return !(*this == rhs);
 }
 
+std::size_t rich_text_hash::operator()(const rich_text &k) const
+{
+    std::size_t seed = 0;
+
+    for (const auto &run : k.runs_)
+    {
+        hash_combine(seed, std::hash<std::string>()(run.first));
+        hash_combine(seed, hash_run_font(run.second));
+    }
+
+    hash_combine(seed, k.phonetic_runs_.size());
+
+    return seed;
+}
+
+std::size_t rich_text_hash::operator()(const std::string &plain_text) const
+{
+    std::size_t seed = 0;
+
+    hash_combine(seed, std::hash<std::string>()(plain_text));
+    hash_combine(seed, 0);
+    hash_combine(seed, 0);
+
+    return seed;
+}
+
 } // namespace xyxlnt
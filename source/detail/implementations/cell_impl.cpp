@@ -22,9 +22,11 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <xyxlnt/workbook/workbook.hpp>
 #include <xyxlnt/worksheet/worksheet.hpp>
 
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/workbook_impl.hpp>
 
 namespace xyxlnt {
 namespace detail {
@@ -33,12 +35,66 @@ cell_impl::cell_impl()
     : type_(cell_type::empty),
       parent_(nullptr),
       column_(1),
-      row_(1),
+      row_(nullptr),
       is_merged_(false),
       phonetics_visible_(false),
       value_numeric_(0)
 {
 }
 
+workbook_impl *cell_impl::parent_workbook() const
+{
+    if (parent_ == nullptr || parent_->parent_ == nullptr)
+    {
+        return nullptr;
+    }
+
+    return parent_->parent_->d_.get();
+}
+
+void cell_impl::assign_shared_string(std::size_t index)
+{
+    release_shared_string();
+
+    type_ = cell_type::shared_string;
+    value_numeric_ = static_cast<double>(index);
+
+    if (auto workbook = parent_workbook())
+    {
+        workbook->reference_shared_string(index);
+    }
+}
+
+void cell_impl::release_shared_string()
+{
+    if (type_ != cell_type::shared_string) return;
+
+    if (auto workbook = parent_workbook())
+    {
+        workbook->release_shared_string(static_cast<std::size_t>(value_numeric_));
+    }
+}
+
+void cell_impl::update_cell_references()
+{
+    auto workbook = parent_workbook();
+
+    // cells being streamed aren't stored in their worksheet and never move
+    if (workbook != nullptr && parent_->find_cell(column_, row()) == this)
+    {
+        workbook->update_reference_cell(this);
+    }
+}
+
+void cell_impl::detach()
+{
+    release_shared_string();
+
+    if (auto workbook = parent_workbook())
+    {
+        workbook->release_reference_cell(this);
+    }
+}
+
 } // namespace detail
 } // namespace xyxlnt
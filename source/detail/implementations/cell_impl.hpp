@@ -38,8 +38,59 @@
 namespace xyxlnt {
 namespace detail {
 
+struct workbook_impl;
 struct worksheet_impl;
 
+/// <summary>
+/// The key of a row of cells in worksheet_impl::cell_map_. Inserting or deleting rows
+/// renumbers every later row by the same amount, which keeps them in order, so the index
+/// is mutable and rewritten in place rather than relinking the row. Cells point to the
+/// key of their row instead of storing their own row number.
+/// </summary>
+struct row_key
+{
+    row_key(row_t row)
+        : index(row)
+    {
+    }
+
+    operator row_t() const
+    {
+        return index;
+    }
+
+    mutable row_t index;
+};
+
+/// <summary>
+/// The key of a cell within its row, renumbered in place like row_key when columns are
+/// inserted or deleted so that the cells after the edit stay in their nodes.
+/// </summary>
+struct column_key
+{
+    column_key(const column_t &column)
+        : index(column.index)
+    {
+    }
+
+    mutable column_t::index_t index;
+};
+
+inline bool operator<(const column_key &lhs, const column_key &rhs)
+{
+    return lhs.index < rhs.index;
+}
+
+inline bool operator==(const column_key &lhs, const column_key &rhs)
+{
+    return lhs.index == rhs.index;
+}
+
+inline bool operator!=(const column_key &lhs, const column_key &rhs)
+{
+    return lhs.index != rhs.index;
+}
+
 struct cell_impl
 {
     cell_impl();
@@ -53,7 +104,12 @@ struct cell_impl
     worksheet_impl *parent_;
 
     column_t column_;
-    row_t row_;
+
+    /// <summary>
+    /// The key of the row this cell is stored in. Cells outside of a worksheet, such as
+    /// those being streamed, point to a key kept by whoever owns them.
+    /// </summary>
+    const row_key *row_;
 
     bool is_merged_;
     bool phonetics_visible_;
@@ -66,6 +122,55 @@ struct cell_impl
     optional<format_impl *> format_;
     optional<comment *> comment_;
 
+    /// <summary>
+    /// Returns the implementation of the workbook this cell belongs to, or null if the
+    /// cell isn't part of a worksheet.
+    /// </summary>
+    workbook_impl *parent_workbook() const;
+
+    /// <summary>
+    /// Returns the row this cell is in.
+    /// </summary>
+    row_t row() const
+    {
+        return row_->index;
+    }
+
+    /// <summary>
+    /// Makes this cell hold the shared string at index and counts the reference in the
+    /// workbook, releasing the string it held before.
+    /// </summary>
+    void assign_shared_string(std::size_t index);
+
+    /// <summary>
+    /// Stops counting this cell as a reference to its shared string, if it holds one.
+    /// Must be called before the value is replaced other than by assign_shared_string or
+    /// the cell is erased.
+    /// </summary>
+    void release_shared_string();
+
+    /// <summary>
+    /// Returns true if this cell has a formula or an internal hyperlink, which may refer
+    /// to other cells and have to be rewritten when rows or columns are inserted or deleted.
+    /// </summary>
+    bool has_cell_references() const
+    {
+        return formula_.is_set()
+            || (hyperlink_.is_set() && hyperlink_.get().relationship.target_mode() == target_mode::internal);
+    }
+
+    /// <summary>
+    /// Adds this cell to or removes it from the workbook's index of cells with references.
+    /// Must be called after the formula or hyperlink of a cell in a worksheet changes.
+    /// </summary>
+    void update_cell_references();
+
+    /// <summary>
+    /// Removes this cell from the shared string counts and the reference index of its
+    /// workbook. Must be called before the cell is erased.
+    /// </summary>
+    void detach();
+
     bool is_garbage_collectible() const
     {
         return !(type_ != cell_type::empty || is_merged_ || phonetics_visible_ || formula_.is_set() || format_.is_set() || hyperlink_.is_set());
@@ -77,7 +182,7 @@ inline bool operator==(const cell_impl &lhs, const cell_impl &rhs)
     // not comparing parent
     return lhs.type_ == rhs.type_
         && lhs.column_ == rhs.column_
-        && lhs.row_ == rhs.row_
+        && lhs.row() == rhs.row()
         && lhs.is_merged_ == rhs.is_merged_
         && lhs.phonetics_visible_ == rhs.phonetics_visible_
         && lhs.value_text_ == rhs.value_text_
@@ -0,0 +1,239 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace xyxlnt {
+namespace detail {
+
+/// <summary>
+/// Hands out blocks carved from large slabs so that filling a worksheet doesn't make one
+/// heap allocation per cell. Freed blocks are kept on a free list per size and reused
+/// by the next allocation of that size, which suits the fixed-size nodes of the cell
+/// maps. Slabs are only returned to the heap when the arena is destroyed, so dropping a
+/// whole worksheet costs one deallocation per slab rather than one per cell.
+/// </summary>
+class memory_arena
+{
+public:
+    memory_arena() = default;
+    memory_arena(const memory_arena &) = delete;
+    memory_arena &operator=(const memory_arena &) = delete;
+
+    ~memory_arena()
+    {
+        for (auto slab : slabs_)
+        {
+            ::operator delete(slab);
+        }
+    }
+
+    void *allocate(std::size_t size)
+    {
+        size = round_up(size);
+
+        if (size > max_block_size)
+        {
+            bytes_ += size;
+            return ::operator new(size);
+        }
+
+        auto &blocks = free_blocks(size);
+
+        if (blocks.head != nullptr)
+        {
+            auto block = blocks.head;
+            blocks.head = block->next;
+
+            return block;
+        }
+
+        if (size > remaining_)
+        {
+            add_slab();
+        }
+
+        auto block = cursor_;
+        cursor_ += size;
+        remaining_ -= size;
+
+        return block;
+    }
+
+    void deallocate(void *block, std::size_t size)
+    {
+        size = round_up(size);
+
+        if (size > max_block_size)
+        {
+            bytes_ -= size;
+            ::operator delete(block);
+
+            return;
+        }
+
+        auto &blocks = free_blocks(size);
+        auto freed = static_cast<free_block *>(block);
+        freed->next = blocks.head;
+        blocks.head = freed;
+    }
+
+    /// <summary>
+    /// Returns the bytes this arena holds on the heap, including free blocks and the
+    /// unused end of the current slab.
+    /// </summary>
+    std::size_t bytes() const
+    {
+        return bytes_;
+    }
+
+private:
+    struct free_block
+    {
+        free_block *next;
+    };
+
+    struct free_list
+    {
+        std::size_t size;
+        free_block *head;
+    };
+
+    static const std::size_t alignment = alignof(std::max_align_t);
+
+    // larger blocks are rare and go straight to the heap
+    static const std::size_t max_block_size = 1024;
+
+    // slabs double from the first size up to the last so small sheets stay small
+    static const std::size_t first_slab_size = 4096;
+    static const std::size_t last_slab_size = 1 << 20;
+
+    static std::size_t round_up(std::size_t size)
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    free_list &free_blocks(std::size_t size)
+    {
+        // the cell maps only ever use two block sizes
+        for (auto &list : free_lists_)
+        {
+            if (list.size == size) return list;
+        }
+
+        free_lists_.push_back(free_list{size, nullptr});
+
+        return free_lists_.back();
+    }
+
+    void add_slab()
+    {
+        slabs_.reserve(slabs_.size() + 1);
+        cursor_ = static_cast<char *>(::operator new(next_slab_size_));
+        slabs_.push_back(cursor_);
+        remaining_ = next_slab_size_;
+        bytes_ += next_slab_size_;
+
+        if (next_slab_size_ < last_slab_size)
+        {
+            next_slab_size_ *= 2;
+        }
+    }
+
+    std::vector<void *> slabs_;
+    std::vector<free_list> free_lists_;
+    char *cursor_ = nullptr;
+    std::size_t remaining_ = 0;
+    std::size_t next_slab_size_ = first_slab_size;
+    std::size_t bytes_ = 0;
+};
+
+/// <summary>
+/// Allocates from a memory_arena. A default-constructed allocator has no arena and
+/// uses the heap directly. Allocators compare equal when they share an arena so that
+/// moving a container to another owner copies its elements into the new arena.
+/// </summary>
+template <typename T>
+class arena_allocator
+{
+public:
+    using value_type = T;
+
+    arena_allocator() = default;
+
+    explicit arena_allocator(memory_arena *arena)
+        : arena_(arena)
+    {
+    }
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U> &other)
+        : arena_(other.arena())
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        if (arena_ == nullptr) return std::allocator<T>().allocate(n);
+
+        return static_cast<T *>(arena_->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n)
+    {
+        if (arena_ == nullptr)
+        {
+            std::allocator<T>().deallocate(p, n);
+            return;
+        }
+
+        arena_->deallocate(p, n * sizeof(T));
+    }
+
+    memory_arena *arena() const
+    {
+        return arena_;
+    }
+
+private:
+    memory_arena *arena_ = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const arena_allocator<T> &lhs, const arena_allocator<U> &rhs)
+{
+    return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const arena_allocator<T> &lhs, const arena_allocator<U> &rhs)
+{
+    return !(lhs == rhs);
+}
+
+} // namespace detail
+} // namespace xyxlnt
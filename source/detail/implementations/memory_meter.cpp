@@ -0,0 +1,271 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <xyxlnt/cell/comment.hpp>
+#include <xyxlnt/cell/rich_text.hpp>
+#include <xyxlnt/packaging/manifest.hpp>
+#include <xyxlnt/styles/font.hpp>
+#include <xyxlnt/styles/number_format.hpp>
+#include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/hyperlink_impl.hpp>
+#include <detail/implementations/memory_meter.hpp>
+#include <detail/implementations/stylesheet.hpp>
+#include <detail/implementations/workbook_impl.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
+
+namespace {
+
+template <typename T>
+std::size_t vector_bytes(const std::vector<T> &values)
+{
+    return values.capacity() * sizeof(T);
+}
+
+std::size_t font_heap_bytes(const xyxlnt::font &font)
+{
+    using xyxlnt::detail::memory_meter;
+
+    return (font.has_name() ? memory_meter::heap_bytes(font.name()) : 0)
+        + (font.has_scheme() ? memory_meter::heap_bytes(font.scheme()) : 0);
+}
+
+std::size_t relationship_heap_bytes(const xyxlnt::relationship &relationship)
+{
+    using xyxlnt::detail::memory_meter;
+
+    return memory_meter::heap_bytes(relationship.id())
+        + memory_meter::heap_bytes(relationship.source().path().string())
+        + memory_meter::heap_bytes(relationship.target().path().string());
+}
+
+} // namespace
+
+namespace xyxlnt {
+
+namespace detail {
+
+memory_usage memory_meter::measure(const worksheet_impl &worksheet)
+{
+    memory_usage usage;
+    usage.cells = worksheet.cell_arena_.bytes();
+
+    for (const auto &row : worksheet.cell_map_)
+    {
+        for (const auto &cell : row.second)
+        {
+            usage.cells += heap_bytes(cell.second);
+        }
+    }
+
+    usage.comments = node_bytes(worksheet.comments_);
+
+    for (const auto &note : worksheet.comments_)
+    {
+        usage.comments += heap_bytes(note.first) + heap_bytes(note.second);
+    }
+
+    return usage;
+}
+
+memory_usage memory_meter::measure(const workbook_impl &workbook)
+{
+    memory_usage usage;
+
+    for (const auto &worksheet : workbook.worksheets_)
+    {
+        usage += measure(worksheet);
+    }
+
+    usage.shared_strings = vector_bytes(workbook.shared_strings_values_)
+        + workbook.shared_strings_index_.heap_bytes()
+        + vector_bytes(workbook.shared_string_references_);
+
+    for (const auto &text : workbook.shared_strings_values_)
+    {
+        usage.shared_strings += heap_bytes(text);
+    }
+
+    if (workbook.stylesheet_.is_set())
+    {
+        usage.styles = heap_bytes(workbook.stylesheet_.get());
+    }
+
+    for (const auto *parts : {&workbook.images_, &workbook.binaries_})
+    {
+        usage.images_and_binaries += node_bytes(*parts);
+
+        for (const auto &part : *parts)
+        {
+            usage.images_and_binaries += heap_bytes(part.first) + vector_bytes(part.second);
+        }
+    }
+
+    usage.manifest = heap_bytes(workbook.manifest_);
+
+    return usage;
+}
+
+std::size_t memory_meter::heap_bytes(const std::string &text)
+{
+    // short strings are stored inside the object itself
+    const auto object = reinterpret_cast<const char *>(&text);
+    if (text.data() >= object && text.data() < object + sizeof(text)) return 0;
+
+    return text.capacity() + 1;
+}
+
+std::size_t memory_meter::heap_bytes(const rich_text &text)
+{
+    auto bytes = vector_bytes(text.runs_) + vector_bytes(text.phonetic_runs_);
+
+    for (const auto &run : text.runs_)
+    {
+        bytes += heap_bytes(run.first);
+
+        if (run.second.is_set())
+        {
+            bytes += font_heap_bytes(run.second.get());
+        }
+    }
+
+    for (const auto &run : text.phonetic_runs_)
+    {
+        bytes += heap_bytes(run.text);
+    }
+
+    return bytes;
+}
+
+std::size_t memory_meter::heap_bytes(const comment &note)
+{
+    return heap_bytes(note.text_) + heap_bytes(note.author_) + heap_bytes(note.fill_);
+}
+
+std::size_t memory_meter::heap_bytes(const cell_impl &cell)
+{
+    auto bytes = heap_bytes(cell.value_text_);
+
+    if (cell.formula_.is_set())
+    {
+        bytes += heap_bytes(cell.formula_.get());
+    }
+
+    if (cell.hyperlink_.is_set())
+    {
+        const auto &link = cell.hyperlink_.get();
+        bytes += relationship_heap_bytes(link.relationship);
+
+        for (const auto *text : {&link.location, &link.tooltip, &link.display})
+        {
+            if (text->is_set())
+            {
+                bytes += heap_bytes(text->get());
+            }
+        }
+    }
+
+    return bytes;
+}
+
+std::size_t memory_meter::heap_bytes(const stylesheet &styles)
+{
+    auto bytes = node_bytes(styles.conditional_format_impls)
+        + node_bytes(styles.format_impls)
+        + node_bytes(styles.format_index)
+        + vector_bytes(styles.format_positions)
+        + node_bytes(styles.style_impls)
+        + vector_bytes(styles.style_names)
+        + vector_bytes(styles.alignments)
+        + vector_bytes(styles.borders)
+        + vector_bytes(styles.fills)
+        + vector_bytes(styles.fonts)
+        + vector_bytes(styles.number_formats)
+        + vector_bytes(styles.protections)
+        + node_bytes(styles.alignment_index)
+        + node_bytes(styles.border_index)
+        + node_bytes(styles.fill_index)
+        + node_bytes(styles.font_index)
+        + node_bytes(styles.number_format_index)
+        + node_bytes(styles.protection_index)
+        + vector_bytes(styles.colors);
+
+    for (const auto &style : styles.style_impls)
+    {
+        bytes += heap_bytes(style.first) + heap_bytes(style.second.name);
+    }
+
+    for (const auto &name : styles.style_names)
+    {
+        bytes += heap_bytes(name);
+    }
+
+    for (const auto &font : styles.fonts)
+    {
+        bytes += font_heap_bytes(font);
+    }
+
+    for (const auto &format : styles.number_formats)
+    {
+        const auto format_string = format.format_string();
+        bytes += heap_bytes(format_string);
+    }
+
+    if (styles.default_slicer_style.is_set())
+    {
+        bytes += heap_bytes(styles.default_slicer_style.get());
+    }
+
+    return bytes;
+}
+
+std::size_t memory_meter::heap_bytes(const manifest &package)
+{
+    auto bytes = node_bytes(package.default_content_types_)
+        + node_bytes(package.override_content_types_)
+        + node_bytes(package.relationships_);
+
+    for (const auto &type : package.default_content_types_)
+    {
+        bytes += heap_bytes(type.first) + heap_bytes(type.second);
+    }
+
+    for (const auto &type : package.override_content_types_)
+    {
+        bytes += heap_bytes(type.first.string()) + heap_bytes(type.second);
+    }
+
+    for (const auto &part : package.relationships_)
+    {
+        bytes += heap_bytes(part.first.string()) + node_bytes(part.second);
+
+        for (const auto &relationship : part.second)
+        {
+            bytes += heap_bytes(relationship.first) + relationship_heap_bytes(relationship.second);
+        }
+    }
+
+    return bytes;
+}
+
+} // namespace detail
+} // namespace xyxlnt
@@ -0,0 +1,101 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include <xyxlnt/xyxlnt_config.hpp>
+#include <xyxlnt/workbook/memory_usage.hpp>
+
+namespace xyxlnt {
+
+class comment;
+class manifest;
+class rich_text;
+
+namespace detail {
+
+struct cell_impl;
+struct stylesheet;
+struct workbook_impl;
+struct worksheet_impl;
+
+/// <summary>
+/// Measures the heap memory behind workbook::memory_usage and worksheet::memory_usage.
+/// Cell nodes are counted as the slabs of the arena they're allocated from. Everything else
+/// is measured by walking the containers: the capacity of vectors and strings, and one
+/// node per element plus the bucket array for node-based containers.
+/// </summary>
+class memory_meter
+{
+public:
+    /// <summary>
+    /// Returns the cells and comments of worksheet.
+    /// </summary>
+    static memory_usage measure(const worksheet_impl &worksheet);
+
+    /// <summary>
+    /// Returns the workbook-level storage of workbook plus the sum over its worksheets.
+    /// </summary>
+    static memory_usage measure(const workbook_impl &workbook);
+
+    /// <summary>
+    /// Returns the heap bytes owned by the argument, not counting the object itself.
+    /// </summary>
+    static std::size_t heap_bytes(const std::string &text);
+    static std::size_t heap_bytes(const rich_text &text);
+    static std::size_t heap_bytes(const comment &note);
+    static std::size_t heap_bytes(const cell_impl &cell);
+    static std::size_t heap_bytes(const stylesheet &styles);
+    static std::size_t heap_bytes(const manifest &package);
+
+    /// <summary>
+    /// Returns the nodes and buckets of the hash container values, not counting
+    /// what its keys and values own.
+    /// </summary>
+    template <typename Map>
+    static std::size_t node_bytes(const Map &values)
+    {
+        // a node holds the value, a next pointer and the cached hash while a table
+        // that was never filled only has a single bucket stored inline
+        const auto buckets = values.bucket_count() > 1 ? values.bucket_count() : 0;
+
+        return values.size() * (sizeof(typename Map::value_type) + sizeof(void *) + sizeof(std::size_t))
+            + buckets * sizeof(void *);
+    }
+
+    /// <summary>
+    /// Returns the nodes of values, not counting what the elements own.
+    /// </summary>
+    template <typename T>
+    static std::size_t node_bytes(const std::list<T> &values)
+    {
+        return values.size() * (sizeof(T) + 2 * sizeof(void *));
+    }
+};
+
+} // namespace detail
+} // namespace xyxlnt
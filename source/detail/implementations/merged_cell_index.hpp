@@ -0,0 +1,246 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <xyxlnt/cell/cell_reference.hpp>
+#include <xyxlnt/cell/index_types.hpp>
+#include <xyxlnt/worksheet/range_reference.hpp>
+
+namespace xyxlnt {
+namespace detail {
+
+/// <summary>
+/// The merged ranges of a worksheet, bucketed by height and ordered by their top-left
+/// cell within each bucket. Bucket k holds the ranges whose height is at least 2^k and
+/// less than 2^(k+1). Merged ranges never overlap, so the ranges of a bucket starting
+/// in one row are ordered by both their first and last column. Point and overlap
+/// queries therefore only visit, in each non-empty bucket, the rows a range of that
+/// height could start in. A tall range only widens the search of its own bucket and
+/// stops costing anything once it is removed.
+/// </summary>
+class merged_cell_index
+{
+public:
+    /// <summary>
+    /// Adds range. Returns false without adding it if it overlaps an existing range.
+    /// </summary>
+    bool insert(const range_reference &range)
+    {
+        if (overlaps(range)) return false;
+
+        buckets_[bucket(range)].emplace(key(range), range);
+        ++size_;
+
+        return true;
+    }
+
+    /// <summary>
+    /// Removes range. Returns false if it isn't in the index.
+    /// </summary>
+    bool erase(const range_reference &range)
+    {
+        auto &ranges = buckets_[bucket(range)];
+        auto match = ranges.find(key(range));
+
+        if (match == ranges.end() || match->second != range) return false;
+
+        ranges.erase(match);
+        --size_;
+
+        return true;
+    }
+
+    /// <summary>
+    /// Returns the range containing the given cell or nullptr if it isn't merged.
+    /// </summary>
+    const range_reference *find(column_t column, row_t row) const
+    {
+        for (std::size_t k = 0; k < buckets_.size(); ++k)
+        {
+            const auto &ranges = buckets_[k];
+
+            for (auto start = first_candidate(ranges, k, row); start != ranges.end() && start->first.first <= row;)
+            {
+                const auto top = start->first.first;
+                auto candidate = ranges.upper_bound(std::make_pair(top, column.index));
+
+                if (candidate != ranges.begin())
+                {
+                    --candidate;
+                    const auto &range = candidate->second;
+
+                    if (candidate->first.first == top
+                        && range.bottom_right().column() >= column
+                        && range.bottom_right().row() >= row)
+                    {
+                        return &range;
+                    }
+                }
+
+                if (top >= row) break;
+                start = ranges.lower_bound(std::make_pair(top + 1, column_t::index_t(0)));
+            }
+        }
+
+        return nullptr;
+    }
+
+    /// <summary>
+    /// Returns true if any cell of range is part of an existing merged range.
+    /// </summary>
+    bool overlaps(const range_reference &range) const
+    {
+        const auto first_column = range.top_left().column_index();
+        const auto last_column = range.bottom_right().column_index();
+        const auto first_row = range.top_left().row();
+        const auto last_row = range.bottom_right().row();
+
+        for (std::size_t k = 0; k < buckets_.size(); ++k)
+        {
+            const auto &ranges = buckets_[k];
+
+            for (auto start = first_candidate(ranges, k, first_row); start != ranges.end() && start->first.first <= last_row;)
+            {
+                const auto top = start->first.first;
+                auto candidate = ranges.upper_bound(std::make_pair(top, last_column));
+
+                // ranges starting in this row are ordered by their last column too,
+                // so walk back only while they still reach into range's columns
+                while (candidate != ranges.begin())
+                {
+                    --candidate;
+                    const auto &existing = candidate->second;
+
+                    if (candidate->first.first != top || existing.bottom_right().column_index() < first_column) break;
+                    if (existing.bottom_right().row() >= first_row) return true;
+                }
+
+                if (top >= last_row) break;
+                start = ranges.lower_bound(std::make_pair(top + 1, column_t::index_t(0)));
+            }
+        }
+
+        return false;
+    }
+
+    /// <summary>
+    /// Returns all ranges ordered by their top-left cell in row-major order.
+    /// </summary>
+    std::vector<range_reference> ranges() const
+    {
+        std::vector<std::pair<key_type, range_reference>> entries;
+        entries.reserve(size_);
+
+        for (const auto &ranges : buckets_)
+        {
+            entries.insert(entries.end(), ranges.begin(), ranges.end());
+        }
+
+        std::sort(entries.begin(), entries.end(),
+            [](const std::pair<key_type, range_reference> &a, const std::pair<key_type, range_reference> &b) {
+                return a.first < b.first;
+            });
+
+        std::vector<range_reference> result;
+        result.reserve(entries.size());
+
+        for (const auto &entry : entries)
+        {
+            result.push_back(entry.second);
+        }
+
+        return result;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    void clear()
+    {
+        for (auto &ranges : buckets_)
+        {
+            ranges.clear();
+        }
+
+        size_ = 0;
+    }
+
+    bool operator==(const merged_cell_index &rhs) const
+    {
+        return buckets_ == rhs.buckets_;
+    }
+
+private:
+    using key_type = std::pair<row_t, column_t::index_t>;
+    using range_map = std::map<key_type, range_reference>;
+
+    static key_type key(const range_reference &range)
+    {
+        return std::make_pair(range.top_left().row(), range.top_left().column_index());
+    }
+
+    // the index of the bucket holding ranges as tall as range, floor(log2(height))
+    static std::size_t bucket(const range_reference &range)
+    {
+        std::size_t k = 0;
+
+        for (auto height = range.height(); height > 1; height >>= 1)
+        {
+            ++k;
+        }
+
+        return k;
+    }
+
+    // the first range of bucket k that could reach down to row, given that none
+    // of its ranges is 2^(k+1) rows tall
+    static range_map::const_iterator first_candidate(const range_map &ranges, std::size_t k, row_t row)
+    {
+        const auto max_height = static_cast<row_t>((std::uint64_t(2) << k) - 1);
+        const auto first_top = row >= max_height ? row - max_height + 1 : row_t(1);
+
+        return ranges.lower_bound(std::make_pair(first_top, column_t::index_t(0)));
+    }
+
+    // one bucket per bit of row_t, enough for a range spanning every row
+    std::array<range_map, 32> buckets_;
+    std::size_t size_ = 0;
+};
+
+} // namespace detail
+} // namespace xyxlnt
@@ -0,0 +1,173 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <xyxlnt/cell/rich_text.hpp>
+
+namespace xyxlnt {
+namespace detail {
+
+/// <summary>
+/// Finds shared strings by value without keeping a second copy of them. The strings
+/// themselves stay in the workbook's shared string vector and this open-addressed table
+/// holds only their ids and hashes. Ids appended to the vector without going through
+/// the index (e.g. by the consumer, which keeps duplicates) are indexed lazily by sync.
+/// </summary>
+class shared_string_index
+{
+public:
+    /// <summary>
+    /// Returned by find when no equal string is indexed.
+    /// </summary>
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// <summary>
+    /// Indexes any strings added to values since the last call. If values shrank, the
+    /// index is rebuilt. When several strings are equal, the earliest one is kept.
+    /// </summary>
+    void sync(const std::vector<rich_text> &values)
+    {
+        if (values.size() < indexed_)
+        {
+            clear();
+        }
+
+        for (; indexed_ < values.size(); ++indexed_)
+        {
+            const auto hash = rich_text_hash()(values[indexed_]);
+
+            if (find(values, values[indexed_], hash) == npos)
+            {
+                insert(hash, indexed_);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Returns the id of the indexed string equal to text or npos.
+    /// </summary>
+    template <typename Text>
+    std::size_t find(const std::vector<rich_text> &values, const Text &text) const
+    {
+        return find(values, text, rich_text_hash()(text));
+    }
+
+    void clear()
+    {
+        slots_.clear();
+        indexed_ = 0;
+        used_ = 0;
+    }
+
+    /// <summary>
+    /// Returns the bytes allocated for the slot table.
+    /// </summary>
+    std::size_t heap_bytes() const
+    {
+        return slots_.capacity() * sizeof(slot);
+    }
+
+private:
+    struct slot
+    {
+        std::size_t hash;
+        std::size_t id;
+    };
+
+    template <typename Text>
+    std::size_t find(const std::vector<rich_text> &values, const Text &text, std::size_t hash) const
+    {
+        if (slots_.empty()) return npos;
+
+        const auto mask = slots_.size() - 1;
+
+        for (auto position = hash & mask; slots_[position].id != npos; position = (position + 1) & mask)
+        {
+            const auto &candidate = slots_[position];
+
+            if (candidate.hash == hash && values[candidate.id] == text)
+            {
+                return candidate.id;
+            }
+        }
+
+        return npos;
+    }
+
+    void insert(std::size_t hash, std::size_t id)
+    {
+        // keep the table at most half full so probe sequences stay short
+        if ((used_ + 1) * 2 > slots_.size())
+        {
+            grow();
+        }
+
+        const auto mask = slots_.size() - 1;
+        auto position = hash & mask;
+
+        while (slots_[position].id != npos)
+        {
+            position = (position + 1) & mask;
+        }
+
+        slots_[position] = slot{hash, id};
+        ++used_;
+    }
+
+    void grow()
+    {
+        std::vector<slot> old_slots(slots_.empty() ? 16 : slots_.size() * 2, slot{0, npos});
+        old_slots.swap(slots_);
+        used_ = 0;
+
+        for (const auto &entry : old_slots)
+        {
+            if (entry.id != npos)
+            {
+                insert(entry.hash, entry.id);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Power-of-two sized table of (hash, id) pairs, empty slots having id npos.
+    /// </summary>
+    std::vector<slot> slots_;
+
+    /// <summary>
+    /// The number of leading strings in the value vector that have been considered.
+    /// </summary>
+    std::size_t indexed_ = 0;
+
+    /// <summary>
+    /// The number of occupied slots.
+    /// </summary>
+    std::size_t used_ = 0;
+};
+
+} // namespace detail
+} // namespace xyxlnt
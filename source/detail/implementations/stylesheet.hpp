@@ -23,8 +23,11 @@
 // @author: see AUTHORS file
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <list>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <detail/implementations/conditional_format_impl.hpp>
@@ -53,16 +56,16 @@ struct stylesheet
 		impl.id = format_impls.size() - 1;
 
         impl.references = default_format ? 1 : 0;
-        
+        index_format(&impl);
+        format_positions.push_back(&impl);
+
         return xyxlnt::format(&impl);
     }
 
     class xyxlnt::format format(std::size_t index)
     {
-        auto iter = format_impls.begin();
-        std::advance(iter, static_cast<std::list<format_impl>::difference_type>(index));
-
-        return xyxlnt::format(&*iter);
+        ensure_format_index();
+        return xyxlnt::format(format_positions.at(index));
     }
 
     class style create_style(const std::string &name)
@@ -172,48 +175,205 @@ struct stylesheet
 		return id;
 	}
     
-    template<typename T, typename C>
-    std::size_t find_or_add(C &container, const T &item)
+    static void hash_combine(std::size_t &seed, std::size_t value)
+    {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    // The component hashes below only need to agree with operator== of each component,
+    // so fields that are expensive to hash may be left out.
+
+    static std::size_t hash_component(const xyxlnt::color &c)
     {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wsign-conversion"
-        auto iter = std::find(container.begin(), container.end(), item);
-        if (iter != container.end())
+        std::size_t seed = static_cast<std::size_t>(c.type()) + (c.auto_() ? 8 : 0);
+
+        switch (c.type())
         {
-            return std::size_t(iter - container.begin());
+        case color_type::indexed:
+            hash_combine(seed, c.indexed().index());
+            break;
+        case color_type::theme:
+            hash_combine(seed, c.theme().index());
+            break;
+        case color_type::rgb:
+            for (auto channel : c.rgb().rgba())
+            {
+                hash_combine(seed, channel);
+            }
+            break;
         }
-        iter = container.emplace(container.end(), item);
-        return std::size_t(iter - container.begin());
-#pragma GCC diagnostic pop
+
+        return seed;
     }
-    
+
+    static std::size_t hash_component(const alignment &a)
+    {
+        std::size_t seed = (a.wrap() ? 1u : 0u) | (a.shrink() ? 2u : 0u);
+        hash_combine(seed, a.horizontal().is_set() ? static_cast<std::size_t>(a.horizontal().get()) + 1 : 0);
+        hash_combine(seed, a.vertical().is_set() ? static_cast<std::size_t>(a.vertical().get()) + 1 : 0);
+        hash_combine(seed, a.indent().is_set() ? static_cast<std::size_t>(a.indent().get()) + 1 : 0);
+        hash_combine(seed, a.rotation().is_set() ? static_cast<std::size_t>(a.rotation().get()) + 1 : 0);
+
+        return seed;
+    }
+
+    static std::size_t hash_component(const border &b)
+    {
+        std::size_t seed = b.diagonal().is_set() ? static_cast<std::size_t>(b.diagonal().get()) + 1 : 0;
+
+        for (auto side : border::all_sides())
+        {
+            const auto property = b.side(side);
+
+            if (!property.is_set())
+            {
+                hash_combine(seed, 0);
+                continue;
+            }
+
+            const auto style = property.get().style();
+            const auto color = property.get().color();
+            hash_combine(seed, style.is_set() ? static_cast<std::size_t>(style.get()) + 1 : 0);
+            hash_combine(seed, color.is_set() ? hash_component(color.get()) : 0);
+        }
+
+        return seed;
+    }
+
+    static std::size_t hash_component(const fill &f)
+    {
+        std::size_t seed = static_cast<std::size_t>(f.type());
+
+        if (f.type() == fill_type::pattern)
+        {
+            const auto pattern = f.pattern_fill();
+            hash_combine(seed, static_cast<std::size_t>(pattern.type()));
+            hash_combine(seed, pattern.foreground().is_set() ? hash_component(pattern.foreground().get()) : 0);
+            hash_combine(seed, pattern.background().is_set() ? hash_component(pattern.background().get()) : 0);
+        }
+        else
+        {
+            hash_combine(seed, static_cast<std::size_t>(f.gradient_fill().type()));
+        }
+
+        return seed;
+    }
+
+    static std::size_t hash_component(const font &f)
+    {
+        std::size_t seed = f.has_name() ? std::hash<std::string>()(f.name()) : 0;
+        // + 0.0 so that -0.0 and 0.0, which compare equal, hash the same
+        hash_combine(seed, f.has_size() ? std::hash<double>()(f.size() + 0.0) : 0);
+        hash_combine(seed, f.has_color() ? hash_component(f.color()) : 0);
+        hash_combine(seed, f.has_family() ? f.family() + 1 : 0);
+        hash_combine(seed, static_cast<std::size_t>(f.underline()));
+        hash_combine(seed, (f.bold() ? 1u : 0u) | (f.italic() ? 2u : 0u) | (f.strikethrough() ? 4u : 0u)
+            | (f.superscript() ? 8u : 0u) | (f.subscript() ? 16u : 0u) | (f.shadow() ? 32u : 0u));
+
+        return seed;
+    }
+
+    static std::size_t hash_component(const number_format &nf)
+    {
+        return std::hash<std::string>()(nf.format_string());
+    }
+
+    static std::size_t hash_component(const protection &p)
+    {
+        return (p.locked() ? 1u : 0u) | (p.hidden() ? 2u : 0u);
+    }
+
+    /// <summary>
+    /// Maps the hash of each component in one of the component vectors to its position.
+    /// </summary>
+    using component_index = std::unordered_multimap<std::size_t, std::size_t>;
+
+    component_index &index_for(const std::vector<alignment> &) { return alignment_index; }
+    component_index &index_for(const std::vector<border> &) { return border_index; }
+    component_index &index_for(const std::vector<fill> &) { return fill_index; }
+    component_index &index_for(const std::vector<font> &) { return font_index; }
+    component_index &index_for(const std::vector<number_format> &) { return number_format_index; }
+    component_index &index_for(const std::vector<protection> &) { return protection_index; }
+
     template<typename T>
-    std::unordered_map<std::size_t, std::size_t> garbage_collect(
-        const std::unordered_map<std::size_t, std::size_t> &reference_counts,
+    std::size_t find_or_add(std::vector<T> &container, const T &item)
+    {
+        auto &index = index_for(container);
+
+        // components may be added directly by the consumer, so rebuild when out of step
+        if (index.size() != container.size())
+        {
+            index.clear();
+
+            for (std::size_t i = 0; i < container.size(); ++i)
+            {
+                index.emplace(hash_component(container[i]), i);
+            }
+        }
+
+        const auto hash = hash_component(item);
+        auto range = index.equal_range(hash);
+        auto match = container.size();
+
+        // prefer the earliest equal component as the previous linear search did
+        for (auto entry = range.first; entry != range.second; ++entry)
+        {
+            if (entry->second < match && container[entry->second] == item)
+            {
+                match = entry->second;
+            }
+        }
+
+        if (match == container.size())
+        {
+            container.push_back(item);
+            index.emplace(hash, match);
+        }
+
+        return match;
+    }
+
+    /// <summary>
+    /// Removes the components of container that have no references, keeping the order of
+    /// the rest, and returns a table mapping each old position to the new one.
+    /// </summary>
+    template<typename T>
+    std::vector<std::size_t> garbage_collect(
+        const std::vector<std::size_t> &reference_counts,
         std::vector<T> &container)
     {
-        std::unordered_map<std::size_t, std::size_t> id_map;
-        std::size_t unreferenced = 0;
-        const auto original_size = container.size();
+        std::vector<std::size_t> id_map(container.size(), 0);
+        std::size_t kept = 0;
 
-        for (std::size_t i = 0; i < original_size; ++i)
+        for (std::size_t i = 0; i < container.size(); ++i)
         {
-            id_map[i] = i - unreferenced;
+            id_map[i] = kept;
 
-            if (reference_counts.count(i) == 0 || reference_counts.at(i) == 0)
+            if (reference_counts[i] != 0)
             {
-                container.erase(container.begin() + static_cast<typename std::vector<T>::difference_type>(i - unreferenced));
-                unreferenced++;
+                if (kept != i)
+                {
+                    container[kept] = std::move(container[i]);
+                }
+
+                ++kept;
             }
         }
 
+        container.erase(container.begin() + static_cast<typename std::vector<T>::difference_type>(kept), container.end());
+        index_for(container).clear();
+
         return id_map;
     }
-    
+
     void garbage_collect()
     {
         if (!garbage_collection_enabled) return;
-        
+
+        unreferenced_formats = 0;
+        format_index.clear();
+        format_positions.clear();
+
         auto format_iter = format_impls.begin();
         while (format_iter != format_impls.end())
         {
@@ -229,182 +389,253 @@ struct stylesheet
             }
         }
         
+        // mark: count references to each component from the remaining formats and styles
+        std::vector<std::size_t> alignment_reference_counts(alignments.size(), 0);
+        std::vector<std::size_t> border_reference_counts(borders.size(), 0);
+        std::vector<std::size_t> fill_reference_counts(fills.size(), 0);
+        std::vector<std::size_t> font_reference_counts(fonts.size(), 0);
+        std::vector<std::size_t> protection_reference_counts(protections.size(), 0);
+
+        auto mark = [](std::vector<std::size_t> &counts, const optional<std::size_t> &id) {
+            if (id.is_set() && id.get() < counts.size())
+            {
+                ++counts[id.get()];
+            }
+        };
+
+        // the first two fills are reserved by the spec
+        for (std::size_t i = 0; i < std::min(fill_reference_counts.size(), std::size_t(2)); ++i)
+        {
+            ++fill_reference_counts[i];
+        }
+
         std::size_t new_id = 0;
 
-        std::unordered_map<std::size_t, std::size_t> alignment_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> border_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> fill_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> font_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> number_format_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> protection_reference_counts;
-        
-        fill_reference_counts[0]++;
-        fill_reference_counts[1]++;
-        
         for (auto &impl : format_impls)
         {
             impl.id = new_id++;
-            
-            if (impl.alignment_id.is_set())
-            {
-                alignment_reference_counts[impl.alignment_id.get()]++;
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                border_reference_counts[impl.border_id.get()]++;
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                fill_reference_counts[impl.fill_id.get()]++;
-            }
-            
-            if (impl.font_id.is_set())
-            {
-                font_reference_counts[impl.font_id.get()]++;
-            }
-            
-            if (impl.number_format_id.is_set())
-            {
-                number_format_reference_counts[impl.number_format_id.get()]++;
-            }
-            
-            if (impl.protection_id.is_set())
-            {
-                protection_reference_counts[impl.protection_id.get()]++;
-            }
+            format_positions.push_back(&impl);
+
+            mark(alignment_reference_counts, impl.alignment_id);
+            mark(border_reference_counts, impl.border_id);
+            mark(fill_reference_counts, impl.fill_id);
+            mark(font_reference_counts, impl.font_id);
+            mark(protection_reference_counts, impl.protection_id);
         }
-        
+
         for (auto &name_impl_pair : style_impls)
         {
             auto &impl = name_impl_pair.second;
-            
-            if (impl.alignment_id.is_set())
-            {
-                alignment_reference_counts[impl.alignment_id.get()]++;
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                border_reference_counts[impl.border_id.get()]++;
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                fill_reference_counts[impl.fill_id.get()]++;
-            }
-            
-            if (impl.font_id.is_set())
-            {
-                font_reference_counts[impl.font_id.get()]++;
-            }
-            
-            if (impl.number_format_id.is_set())
-            {
-                number_format_reference_counts[impl.number_format_id.get()]++;
-            }
-            
-            if (impl.protection_id.is_set())
+
+            mark(alignment_reference_counts, impl.alignment_id);
+            mark(border_reference_counts, impl.border_id);
+            mark(fill_reference_counts, impl.fill_id);
+            mark(font_reference_counts, impl.font_id);
+            mark(protection_reference_counts, impl.protection_id);
+        }
+
+        // compact: remove unreferenced components and renumber the references to the rest
+        const auto alignment_id_map = garbage_collect(alignment_reference_counts, alignments);
+        const auto border_id_map = garbage_collect(border_reference_counts, borders);
+        const auto fill_id_map = garbage_collect(fill_reference_counts, fills);
+        const auto font_id_map = garbage_collect(font_reference_counts, fonts);
+        const auto protection_id_map = garbage_collect(protection_reference_counts, protections);
+
+        auto remap = [](const std::vector<std::size_t> &id_map, optional<std::size_t> &id) {
+            if (id.is_set())
             {
-                protection_reference_counts[impl.protection_id.get()]++;
+                id = id.get() < id_map.size() ? id_map[id.get()] : 0;
             }
-        }
-        
-        auto alignment_id_map = garbage_collect(alignment_reference_counts, alignments);
-        auto border_id_map = garbage_collect(border_reference_counts, borders);
-        auto fill_id_map = garbage_collect(fill_reference_counts, fills);
-        auto font_id_map = garbage_collect(font_reference_counts, fonts);
-        auto protection_id_map = garbage_collect(protection_reference_counts, protections);
+        };
 
         for (auto &impl : format_impls)
         {
-            if (impl.alignment_id.is_set())
-            {
-                impl.alignment_id = alignment_id_map[impl.alignment_id.get()];
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                impl.border_id = border_id_map[impl.border_id.get()];
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                impl.fill_id = fill_id_map[impl.fill_id.get()];
-            }
-            
-            if (impl.font_id.is_set())
-            {
-                impl.font_id = font_id_map[impl.font_id.get()];
-            }
-            
-            if (impl.protection_id.is_set())
-            {
-                impl.protection_id = protection_id_map[impl.protection_id.get()];
-            }
+            remap(alignment_id_map, impl.alignment_id);
+            remap(border_id_map, impl.border_id);
+            remap(fill_id_map, impl.fill_id);
+            remap(font_id_map, impl.font_id);
+            remap(protection_id_map, impl.protection_id);
         }
 
         for (auto &name_impl : style_impls)
         {
             auto &impl = name_impl.second;
 
-            if (impl.alignment_id.is_set())
-            {
-                impl.alignment_id = alignment_id_map[impl.alignment_id.get()];
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                impl.border_id = border_id_map[impl.border_id.get()];
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                impl.fill_id = fill_id_map[impl.fill_id.get()];
-            }
-            
-            if (impl.font_id.is_set())
+            remap(alignment_id_map, impl.alignment_id);
+            remap(border_id_map, impl.border_id);
+            remap(fill_id_map, impl.fill_id);
+            remap(font_id_map, impl.font_id);
+            remap(protection_id_map, impl.protection_id);
+        }
+
+        // the format index hashes component ids, which may have changed
+        format_index.clear();
+
+        for (auto &impl : format_impls)
+        {
+            index_format(&impl);
+        }
+    }
+
+    static std::size_t hash_format(const format_impl &impl)
+    {
+        std::size_t seed = 0;
+
+        auto combine = [&seed](std::size_t value) {
+            seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        };
+        auto combine_id = [&combine](const optional<std::size_t> &id, const optional<bool> &applied) {
+            combine(id.is_set() ? id.get() + 1 : 0);
+            combine(applied.is_set() ? (applied.get() ? 2u : 1u) : 0u);
+        };
+
+        combine_id(impl.alignment_id, impl.alignment_applied);
+        combine_id(impl.border_id, impl.border_applied);
+        combine_id(impl.fill_id, impl.fill_applied);
+        combine_id(impl.font_id, impl.font_applied);
+        combine_id(impl.number_format_id, impl.number_format_applied);
+        combine_id(impl.protection_id, impl.protection_applied);
+        combine((impl.pivot_button_ ? 1u : 0u) | (impl.quote_prefix_ ? 2u : 0u));
+        combine(impl.style.is_set() ? std::hash<std::string>()(impl.style.get()) : 0);
+
+        return seed;
+    }
+
+    void index_format(format_impl *impl)
+    {
+        if (format_index_owner != this) return;
+        format_index.emplace(hash_format(*impl), impl);
+    }
+
+    void unindex_format(format_impl *impl)
+    {
+        if (format_index_owner != this) return;
+        auto range = format_index.equal_range(hash_format(*impl));
+
+        for (auto entry = range.first; entry != range.second; ++entry)
+        {
+            if (entry->second == impl)
             {
-                impl.font_id = font_id_map[impl.font_id.get()];
+                format_index.erase(entry);
+                return;
             }
-            
-            if (impl.protection_id.is_set())
+        }
+    }
+
+    /// <summary>
+    /// Changes a format in place, keeping it findable by find_or_create.
+    /// </summary>
+    template <typename Modifier>
+    void modify_format(format_impl *impl, Modifier modify)
+    {
+        unindex_format(impl);
+        modify(*impl);
+        index_format(impl);
+    }
+
+    // The indices are rebuilt if formats were added without going through them (e.g. by
+    // the consumer) or if this stylesheet was copied from another one.
+    void ensure_format_index()
+    {
+        if (format_index_owner == this && format_positions.size() == format_impls.size()) return;
+
+        format_index.clear();
+        format_positions.clear();
+        format_positions.reserve(format_impls.size());
+        format_index_owner = this;
+
+        for (auto &impl : format_impls)
+        {
+            index_format(&impl);
+            format_positions.push_back(&impl);
+        }
+    }
+
+    /// <summary>
+    /// Returns the earliest format equal to pattern, appending a copy of pattern if there
+    /// is none. Reference counts are left unchanged.
+    /// </summary>
+    format_impl *find_or_add_format(const format_impl &pattern)
+    {
+        ensure_format_index();
+
+        format_impl *result = nullptr;
+        auto range = format_index.equal_range(hash_format(pattern));
+
+        // prefer the earliest equal format as the previous linear search did
+        for (auto entry = range.first; entry != range.second; ++entry)
+        {
+            if (*entry->second == pattern && (result == nullptr || entry->second->id < result->id))
             {
-                impl.protection_id = protection_id_map[impl.protection_id.get()];
+                result = entry->second;
             }
         }
+
+        if (result == nullptr)
+        {
+            result = &*format_impls.emplace(format_impls.end(), pattern);
+            result->id = format_impls.size() - 1;
+            result->references = 0;
+            index_format(result);
+            format_positions.push_back(result);
+        }
+
+        result->parent = this;
+
+        return result;
     }
 
-    format_impl *find_or_create(format_impl &pattern)
+    /// <summary>
+    /// Drops one reference to impl, counting it for the next batched garbage collection
+    /// if that was the last one.
+    /// </summary>
+    void release_format(format_impl &impl)
     {
-        pattern.references = 0;
-        std::size_t id = 0;
-        auto iter = format_impls.begin();
-        while (iter != format_impls.end() && !(*iter == pattern))
+        if (impl.references > 0 && --impl.references == 0)
         {
-            ++id;
-            ++iter;
+            ++unreferenced_formats;
         }
-        if (iter == format_impls.end())
+    }
+
+    /// <summary>
+    /// Runs garbage_collect once enough formats have become unreferenced. Pointers to
+    /// unreferenced formats are invalidated when it does.
+    /// </summary>
+    void collect_garbage_if_needed()
+    {
+        // collect in batches so that restyling many cells stays linear overall
+        if (unreferenced_formats > std::max(format_impls.size() / 2, std::size_t(32)))
         {
-            iter = format_impls.emplace(format_impls.end(), pattern);
+            garbage_collect();
         }
-        auto &result = *iter;
+    }
 
-        result.parent = this;
-        result.id = id;
-        result.references++;
-        
-        if (id != pattern.id)
+    format_impl *find_or_create(format_impl &pattern)
+    {
+        pattern.references = 0;
+        auto result = find_or_add_format(pattern);
+        result->references++;
+
+        if (result->id != pattern.id)
         {
-            iter = format_impls.begin();
-            std::advance(iter, static_cast<std::list<format_impl>::difference_type>(pattern.id));
-            iter->references -= iter->references > 0 ? 1 : 0;
-            garbage_collect();
+            auto &previous = *format_positions[pattern.id];
+
+            if (previous.references == 0 && previous.id + 1 == format_impls.size())
+            {
+                // a format fresh from create_format turned out to duplicate an existing one,
+                // e.g. in cell::number_format, and dropping the last format renumbers nothing
+                unindex_format(&previous);
+                format_positions.pop_back();
+                format_impls.pop_back();
+            }
+            else
+            {
+                release_format(previous);
+                collect_garbage_if_needed();
+            }
         }
 
-        return &result;
+        return result;
     }
 
     format_impl *find_or_create_with(format_impl *pattern, const std::string &style_name)
@@ -413,7 +644,7 @@ struct stylesheet
         new_format.style = style_name;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            modify_format(pattern, [&new_format](format_impl &impl) { impl = new_format; });
         }
         return find_or_create(new_format);
     }
@@ -425,7 +656,7 @@ struct stylesheet
         new_format.alignment_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            modify_format(pattern, [&new_format](format_impl &impl) { impl = new_format; });
         }
         return find_or_create(new_format);
     }
@@ -437,7 +668,7 @@ struct stylesheet
         new_format.border_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            modify_format(pattern, [&new_format](format_impl &impl) { impl = new_format; });
         }
         return find_or_create(new_format);
     }
@@ -449,7 +680,7 @@ struct stylesheet
         new_format.fill_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            modify_format(pattern, [&new_format](format_impl &impl) { impl = new_format; });
         }
         return find_or_create(new_format);
     }
@@ -461,7 +692,7 @@ struct stylesheet
         new_format.font_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            modify_format(pattern, [&new_format](format_impl &impl) { impl = new_format; });
         }
         return find_or_create(new_format);
     }
@@ -477,7 +708,7 @@ struct stylesheet
         new_format.number_format_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            modify_format(pattern, [&new_format](format_impl &impl) { impl = new_format; });
         }
         return find_or_create(new_format);
     }
@@ -489,7 +720,7 @@ struct stylesheet
         new_format.protection_applied = applied;
         if (pattern->references == 0)
         {
-            *pattern = new_format;
+            modify_format(pattern, [&new_format](format_impl &impl) { impl = new_format; });
         }
         return find_or_create(new_format);
     }
@@ -504,6 +735,9 @@ struct stylesheet
     {
 		conditional_format_impls.clear();
         format_impls.clear();
+        format_index.clear();
+        format_positions.clear();
+        unreferenced_formats = 0;
         
         style_impls.clear();
         style_names.clear();
@@ -514,6 +748,13 @@ struct stylesheet
         fonts.clear();
         number_formats.clear();
         protections.clear();
+
+        alignment_index.clear();
+        border_index.clear();
+        fill_index.clear();
+        font_index.clear();
+        number_format_index.clear();
+        protection_index.clear();
         
         colors.clear();
     }
@@ -558,6 +799,17 @@ struct stylesheet
 
 	std::list<conditional_format_impl> conditional_format_impls;
     std::list<format_impl> format_impls;
+
+    // content hash -> format, used by find_or_create instead of scanning format_impls
+    std::unordered_multimap<std::size_t, format_impl *> format_index;
+    const stylesheet *format_index_owner = nullptr;
+
+    // format_impls by id; the list keeps formats at stable addresses while this gives
+    // constant time access by index
+    std::vector<format_impl *> format_positions;
+
+    // formats whose last reference was dropped since the last garbage collection
+    std::size_t unreferenced_formats = 0;
     std::unordered_map<std::string, style_impl> style_impls;
     std::vector<std::string> style_names;
     optional<std::string> default_slicer_style;
@@ -568,6 +820,13 @@ struct stylesheet
     std::vector<font> fonts;
     std::vector<number_format> number_formats;
 	std::vector<protection> protections;
+
+    component_index alignment_index;
+    component_index border_index;
+    component_index fill_index;
+    component_index font_index;
+    component_index number_format_index;
+    component_index protection_index;
     
     std::vector<color> colors;
 };
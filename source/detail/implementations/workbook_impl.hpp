@@ -25,8 +25,10 @@
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include <detail/implementations/shared_string_index.hpp>
 #include <detail/implementations/stylesheet.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <xyxlnt/packaging/ext_list.hpp>
@@ -54,8 +56,12 @@ struct workbook_impl
     workbook_impl(const workbook_impl &other)
         : active_sheet_index_(other.active_sheet_index_),
           worksheets_(other.worksheets_),
-          shared_strings_ids_(other.shared_strings_ids_),
           shared_strings_values_(other.shared_strings_values_),
+          shared_strings_index_(other.shared_strings_index_),
+          shared_string_references_(other.shared_string_references_),
+          shared_string_reference_total_(other.shared_string_reference_total_),
+          shared_string_references_valid_(other.shared_string_references_valid_),
+          reference_cells_valid_(false),
           stylesheet_(other.stylesheet_),
           manifest_(other.manifest_),
           theme_(other.theme_),
@@ -73,8 +79,12 @@ struct workbook_impl
         active_sheet_index_ = other.active_sheet_index_;
         worksheets_.clear();
         std::copy(other.worksheets_.begin(), other.worksheets_.end(), back_inserter(worksheets_));
-        shared_strings_ids_ = other.shared_strings_ids_;
         shared_strings_values_ = other.shared_strings_values_;
+        shared_strings_index_ = other.shared_strings_index_;
+        shared_string_references_ = other.shared_string_references_;
+        shared_string_reference_total_ = other.shared_string_reference_total_;
+        shared_string_references_valid_ = other.shared_string_references_valid_;
+        invalidate_reference_cells();
         theme_ = other.theme_;
         manifest_ = other.manifest_;
 
@@ -95,7 +105,7 @@ struct workbook_impl
     {
         return active_sheet_index_ == other.active_sheet_index_
             && worksheets_ == other.worksheets_
-            && shared_strings_ids_ == other.shared_strings_ids_
+            && shared_strings_values_ == other.shared_strings_values_
             && stylesheet_ == other.stylesheet_
             && base_date_ == other.base_date_
             && title_ == other.title_
@@ -120,8 +130,176 @@ struct workbook_impl
     optional<std::size_t> active_sheet_index_;
 
     std::list<worksheet_impl> worksheets_;
-    std::unordered_map<rich_text, std::size_t, rich_text_hash> shared_strings_ids_;
+
+    /// <summary>
+    /// Records that one more cell holds the shared string at index.
+    /// </summary>
+    void reference_shared_string(std::size_t index)
+    {
+        if (!shared_string_references_valid_) return;
+
+        if (index >= shared_string_references_.size())
+        {
+            shared_string_references_.resize(index + 1, 0);
+        }
+
+        ++shared_string_references_[index];
+        ++shared_string_reference_total_;
+    }
+
+    /// <summary>
+    /// Records that a cell which held the shared string at index no longer does.
+    /// </summary>
+    void release_shared_string(std::size_t index)
+    {
+        if (!shared_string_references_valid_) return;
+
+        if (index >= shared_string_references_.size() || shared_string_references_[index] == 0)
+        {
+            // the cell was assigned in a way that wasn't counted
+            invalidate_shared_string_references();
+            return;
+        }
+
+        --shared_string_references_[index];
+        --shared_string_reference_total_;
+    }
+
+    /// <summary>
+    /// Marks the reference counts as unknown after cells were changed without going through
+    /// cell_impl::assign_shared_string and cell_impl::release_shared_string, e.g. by loading.
+    /// The next count_shared_string_references recounts them.
+    /// </summary>
+    void invalidate_shared_string_references()
+    {
+        shared_string_references_valid_ = false;
+        shared_string_references_.clear();
+        shared_string_reference_total_ = 0;
+    }
+
+    /// <summary>
+    /// Makes shared_string_references_ and shared_string_reference_total_ exact, visiting
+    /// every cell once if they were invalidated.
+    /// </summary>
+    void count_shared_string_references()
+    {
+        if (shared_string_references_valid_) return;
+
+        shared_string_references_.assign(shared_strings_values_.size(), 0);
+        shared_string_reference_total_ = 0;
+
+        for (const auto &ws : worksheets_)
+        {
+            for (const auto &row : ws.cell_map_)
+            {
+                for (const auto &cell : row.second)
+                {
+                    if (cell.second.type_ != cell_type::shared_string) continue;
+
+                    const auto index = static_cast<std::size_t>(cell.second.value_numeric_);
+
+                    if (index < shared_string_references_.size())
+                    {
+                        ++shared_string_references_[index];
+                    }
+
+                    ++shared_string_reference_total_;
+                }
+            }
+        }
+
+        shared_string_references_valid_ = true;
+    }
+
+    /// <summary>
+    /// Adds cell to reference_cells_ if it has cell references and removes it otherwise.
+    /// </summary>
+    void update_reference_cell(cell_impl *cell)
+    {
+        if (!reference_cells_valid_) return;
+
+        if (cell->has_cell_references())
+        {
+            reference_cells_.insert(cell);
+        }
+        else
+        {
+            reference_cells_.erase(cell);
+        }
+    }
+
+    /// <summary>
+    /// Removes cell, which is about to be erased, from reference_cells_.
+    /// </summary>
+    void release_reference_cell(cell_impl *cell)
+    {
+        if (!reference_cells_valid_) return;
+
+        reference_cells_.erase(cell);
+    }
+
+    /// <summary>
+    /// Marks reference_cells_ as unknown after cells were added or changed without going
+    /// through cell_impl::update_cell_references, e.g. by loading or copying a sheet.
+    /// </summary>
+    void invalidate_reference_cells()
+    {
+        reference_cells_valid_ = false;
+        reference_cells_.clear();
+    }
+
+    /// <summary>
+    /// Returns every cell in the workbook with cell references, visiting every cell once
+    /// to find them if the index was invalidated.
+    /// </summary>
+    const std::unordered_set<cell_impl *> &reference_cells()
+    {
+        if (reference_cells_valid_) return reference_cells_;
+
+        for (auto &ws : worksheets_)
+        {
+            for (auto &row : ws.cell_map_)
+            {
+                for (auto &cell : row.second)
+                {
+                    if (cell.second.has_cell_references())
+                    {
+                        reference_cells_.insert(&cell.second);
+                    }
+                }
+            }
+        }
+
+        reference_cells_valid_ = true;
+
+        return reference_cells_;
+    }
+
     std::vector<rich_text> shared_strings_values_;
+    shared_string_index shared_strings_index_;
+
+    /// <summary>
+    /// The number of cells holding each shared string, indexed like shared_strings_values_.
+    /// Strings past the end aren't referenced. Only exact while shared_string_references_valid_.
+    /// </summary>
+    std::vector<std::size_t> shared_string_references_;
+
+    /// <summary>
+    /// The number of cells holding any shared string, which is the count attribute of the
+    /// shared string table.
+    /// </summary>
+    std::size_t shared_string_reference_total_ = 0;
+
+    bool shared_string_references_valid_ = true;
+
+    /// <summary>
+    /// The cells in all worksheets with a formula or an internal hyperlink, which are the only
+    /// cells inserting or deleting rows or columns has to rewrite. Only exact while
+    /// reference_cells_valid_.
+    /// </summary>
+    std::unordered_set<cell_impl *> reference_cells_;
+
+    bool reference_cells_valid_ = true;
 
     optional<stylesheet> stylesheet_;
 
@@ -23,8 +23,13 @@
 
 #pragma once
 
+#include <map>
+#include <scoped_allocator>
+#include <set>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <xyxlnt/drawing/spreadsheet_drawing.hpp>
@@ -41,6 +46,8 @@
 #include <xyxlnt/worksheet/print_options.hpp>
 #include <xyxlnt/worksheet/sheet_pr.hpp>
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/merged_cell_index.hpp>
+#include <detail/implementations/memory_arena.hpp>
 
 namespace xyxlnt {
 
@@ -48,6 +55,22 @@ class workbook;
 
 namespace detail {
 
+/// <summary>
+/// The cells of a single row, ordered by column.
+/// </summary>
+using cell_row = std::map<column_key, cell_impl, std::less<column_key>,
+    arena_allocator<std::pair<const column_key, cell_impl>>>;
+
+/// <summary>
+/// All cells of a worksheet indexed by row. Inserting or deleting rows or columns
+/// renumbers the keys after the edit in place, so no node is relinked and the cells
+/// (and any xyxlnt::cell handles pointing to them) stay where they are. The scoped
+/// allocator hands the map's allocator down to each row so that both levels are
+/// allocated from the worksheet's arena.
+/// </summary>
+using cell_row_map = std::map<row_key, cell_row, std::less<row_key>,
+    std::scoped_allocator_adaptor<arena_allocator<std::pair<const row_key, cell_row>>>>;
+
 struct worksheet_impl
 {
     worksheet_impl(workbook *parent_workbook, std::size_t id, const std::string &title)
@@ -72,6 +95,7 @@ struct worksheet_impl
         column_properties_ = other.column_properties_;
         row_properties_ = other.row_properties_;
         cell_map_ = other.cell_map_;
+        garbage_candidates_ = other.garbage_candidates_;
         page_setup_ = other.page_setup_;
         auto_filter_ = other.auto_filter_;
         page_margins_ = other.page_margins_;
@@ -89,12 +113,188 @@ struct worksheet_impl
         sheet_properties_ = other.sheet_properties_;
         print_options_ = other.print_options_;
 
-        for (auto &cell : cell_map_)
+        for (auto &row : cell_map_)
+        {
+            for (auto &cell : row.second)
+            {
+                cell.second.parent_ = this;
+                cell.second.row_ = &row.first;
+            }
+        }
+    }
+
+    cell_impl *find_cell(column_t column, row_t row)
+    {
+        auto row_iter = cell_map_.find(row);
+        if (row_iter == cell_map_.end()) return nullptr;
+
+        auto cell_iter = row_iter->second.find(column);
+        return cell_iter == row_iter->second.end() ? nullptr : &cell_iter->second;
+    }
+
+    const cell_impl *find_cell(column_t column, row_t row) const
+    {
+        auto row_iter = cell_map_.find(row);
+        if (row_iter == cell_map_.end()) return nullptr;
+
+        auto cell_iter = row_iter->second.find(column);
+        return cell_iter == row_iter->second.end() ? nullptr : &cell_iter->second;
+    }
+
+    cell_impl &get_or_create_cell(column_t column, row_t row)
+    {
+        // cells are usually added in row-major order so check the end of each map first
+        auto row_iter = !cell_map_.empty() && cell_map_.rbegin()->first < row
+            ? cell_map_.end()
+            : cell_map_.lower_bound(row);
+
+        if (row_iter == cell_map_.end() || row_iter->first != row)
+        {
+            row_iter = cell_map_.emplace_hint(row_iter, std::piecewise_construct,
+                std::forward_as_tuple(row), std::forward_as_tuple());
+        }
+
+        auto &cells = row_iter->second;
+        auto cell_iter = !cells.empty() && cells.rbegin()->first < column
+            ? cells.end()
+            : cells.lower_bound(column);
+
+        if (cell_iter == cells.end() || cell_iter->first != column)
+        {
+            cell_iter = cells.emplace_hint(cell_iter, column, cell_impl());
+
+            auto &impl = cell_iter->second;
+            impl.parent_ = this;
+            impl.column_ = column;
+            impl.row_ = &row_iter->first;
+        }
+
+        return cell_iter->second;
+    }
+
+    /// <summary>
+    /// Calls visit(cell, row_offset, column_offset) for every cell in the block of
+    /// rows x columns cells starting at first_column/first_row, creating cells as needed.
+    /// Each row node is found once and columns are walked with a running hint, so no
+    /// per-cell lookup is done.
+    /// </summary>
+    template <typename Visitor>
+    void fill_block(column_t first_column, row_t first_row, std::size_t rows, std::size_t columns, Visitor visit)
+    {
+        auto row_iter = cell_map_.lower_bound(first_row);
+
+        for (std::size_t r = 0; r < rows; ++r)
+        {
+            const auto row = static_cast<row_t>(first_row + r);
+
+            if (row_iter == cell_map_.end() || row_iter->first != row)
+            {
+                row_iter = cell_map_.emplace_hint(row_iter, std::piecewise_construct,
+                    std::forward_as_tuple(row), std::forward_as_tuple());
+            }
+
+            auto &cells = row_iter->second;
+            auto cell_iter = cells.lower_bound(first_column);
+
+            for (std::size_t c = 0; c < columns; ++c)
+            {
+                const auto column = column_t(static_cast<column_t::index_t>(first_column.index + c));
+
+                if (cell_iter == cells.end() || cell_iter->first != column)
+                {
+                    cell_iter = cells.emplace_hint(cell_iter, column, cell_impl());
+
+                    auto &impl = cell_iter->second;
+                    impl.parent_ = this;
+                    impl.column_ = column;
+                    impl.row_ = &row_iter->first;
+                }
+
+                visit(cell_iter->second, r, c);
+                ++cell_iter;
+            }
+
+            ++row_iter;
+        }
+    }
+
+    /// <summary>
+    /// Calls visit(cell, row_offset, column_offset) for every existing cell between
+    /// first_column/first_row and last_column/last_row inclusive, in row-major order.
+    /// </summary>
+    template <typename Visitor>
+    void visit_block(column_t first_column, row_t first_row, column_t last_column, row_t last_row, Visitor visit) const
+    {
+        for (auto row_iter = cell_map_.lower_bound(first_row);
+             row_iter != cell_map_.end() && row_iter->first <= last_row; ++row_iter)
         {
-            cell.second.parent_ = this;
+            const auto &cells = row_iter->second;
+
+            for (auto cell_iter = cells.lower_bound(first_column);
+                 cell_iter != cells.end() && cell_iter->first.index <= last_column.index; ++cell_iter)
+            {
+                visit(cell_iter->second,
+                    static_cast<std::size_t>(row_iter->first - first_row),
+                    static_cast<std::size_t>(cell_iter->first.index - first_column.index));
+            }
         }
     }
 
+    template <typename Visitor>
+    void visit_block(column_t first_column, row_t first_row, column_t last_column, row_t last_row, Visitor visit)
+    {
+        for (auto row_iter = cell_map_.lower_bound(first_row);
+             row_iter != cell_map_.end() && row_iter->first <= last_row; ++row_iter)
+        {
+            auto &cells = row_iter->second;
+
+            for (auto cell_iter = cells.lower_bound(first_column);
+                 cell_iter != cells.end() && cell_iter->first.index <= last_column.index; ++cell_iter)
+            {
+                visit(cell_iter->second,
+                    static_cast<std::size_t>(row_iter->first - first_row),
+                    static_cast<std::size_t>(cell_iter->first.index - first_column.index));
+            }
+        }
+    }
+
+    bool erase_cell(column_t column, row_t row)
+    {
+        auto row_iter = cell_map_.find(row);
+        if (row_iter == cell_map_.end()) return false;
+
+        auto erased = row_iter->second.erase(column) > 0;
+
+        if (row_iter->second.empty())
+        {
+            cell_map_.erase(row_iter);
+        }
+
+        return erased;
+    }
+
+    /// <summary>
+    /// Records that the cell at column/row is or has become garbage collectible so that
+    /// the next garbage collection only needs to look at recorded cells.
+    /// </summary>
+    void mark_garbage_candidate(column_t column, row_t row)
+    {
+        // cells are usually created in row-major order so try the end first
+        garbage_candidates_.emplace_hint(garbage_candidates_.end(), row, column);
+    }
+
+    std::size_t cell_count() const
+    {
+        std::size_t count = 0;
+
+        for (const auto &row : cell_map_)
+        {
+            count += row.second.size();
+        }
+
+        return count;
+    }
+
     workbook *parent_;
 
     bool operator==(const worksheet_impl& rhs) const
@@ -132,12 +332,22 @@ struct worksheet_impl
     std::unordered_map<column_t, column_properties> column_properties_;
     std::unordered_map<row_t, row_properties> row_properties_;
 
-    std::unordered_map<cell_reference, cell_impl> cell_map_;
+    /// <summary>
+    /// Backs the nodes of cell_map_ and its rows. Declared before cell_map_ so that it outlives it.
+    /// </summary>
+    memory_arena cell_arena_;
+    cell_row_map cell_map_{cell_row_map::allocator_type(&cell_arena_)};
+
+    /// <summary>
+    /// References of the cells that may be erased by the next garbage collection, ordered
+    /// by row so that inserting or deleting rows only renumbers the entries after the edit.
+    /// </summary>
+    std::set<std::pair<row_t, column_t>> garbage_candidates_;
 
     optional<page_setup> page_setup_;
     optional<range_reference> auto_filter_;
     optional<page_margins> page_margins_;
-    std::vector<range_reference> merged_cells_;
+    merged_cell_index merged_cells_;
     std::unordered_map<std::string, named_range> named_ranges_;
 
     optional<phonetic_pr> phonetic_properties_;
@@ -25,6 +25,7 @@
 #include <cctype>
 #include <cmath>
 #include <limits>
+#include <memory>
 
 #include <xyxlnt/utils/exceptions.hpp>
 #include <xyxlnt/utils/numeric.hpp>
@@ -487,6 +488,115 @@ void unhandled_case(bool error)
     }
 }
 
+// Writes the same characters as std::to_string(value) so that they end at end,
+// returning where they begin.
+char *append_integer(long long value, char *begin, char *end)
+{
+    auto magnitude = value < 0
+        ? 0ULL - static_cast<unsigned long long>(value)
+        : static_cast<unsigned long long>(value);
+    auto position = end;
+
+    do
+    {
+        *--position = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0 && position != begin);
+
+    if (value < 0 && position != begin)
+    {
+        *--position = '-';
+    }
+
+    return position;
+}
+
+void append_integer(long long value, std::string &result)
+{
+    char buffer[24];
+    auto end = buffer + sizeof(buffer);
+    result.append(append_integer(value, buffer, end), end);
+}
+
+void append_unsigned(unsigned long long value, std::string &result)
+{
+    char buffer[24];
+    auto end = buffer + sizeof(buffer);
+    auto position = end;
+
+    do
+    {
+        *--position = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    result.append(position, end);
+}
+
+using xyxlnt::detail::format_code;
+using xyxlnt::detail::format_placeholders;
+using xyxlnt::detail::template_part;
+
+// Sections whose parts format_numbers handles directly. Anything else goes through
+// number_formatter::format_number one value at a time.
+enum class section_kind
+{
+    other,
+    numeric,
+    date_time
+};
+
+section_kind classify(const format_code &section)
+{
+    if (section.is_timedelta) return section_kind::other;
+
+    for (const auto &part : section.parts)
+    {
+        switch (part.type)
+        {
+        case template_part::template_type::text:
+        case template_part::template_type::space:
+            break;
+
+        case template_part::template_type::general:
+            if (section.is_datetime || part.placeholders.scientific) return section_kind::other;
+
+            switch (part.placeholders.type)
+            {
+            case format_placeholders::placeholders_type::general:
+            case format_placeholders::placeholders_type::text:
+            case format_placeholders::placeholders_type::integer_only:
+            case format_placeholders::placeholders_type::integer_part:
+            case format_placeholders::placeholders_type::fractional_part:
+                break;
+            default:
+                return section_kind::other;
+            }
+            break;
+
+        case template_part::template_type::day_number:
+        case template_part::template_type::day_number_leading_zero:
+        case template_part::template_type::month_number:
+        case template_part::template_type::month_number_leading_zero:
+        case template_part::template_type::year_short:
+        case template_part::template_type::year_long:
+        case template_part::template_type::hour:
+        case template_part::template_type::hour_leading_zero:
+        case template_part::template_type::minute:
+        case template_part::template_type::minute_leading_zero:
+        case template_part::template_type::second:
+        case template_part::template_type::second_leading_zero:
+            if (!section.is_datetime) return section_kind::other;
+            break;
+
+        default:
+            return section_kind::other;
+        }
+    }
+
+    return section.is_datetime ? section_kind::date_time : section_kind::numeric;
+}
+
 } // namespace
 
 namespace xyxlnt {
@@ -1477,38 +1587,91 @@ std::pair<format_locale, std::string> number_format_parser::locale_from_string(c
     throw xyxlnt::exception("unknown country code: " + country_code_string);
 }
 
+compiled_number_format::compiled_number_format(const std::string &format_string)
+{
+    number_format_parser parser(format_string);
+    parser.parse();
+    codes = parser.result();
+
+    bool any_datetime = false;
+    bool any_timedelta = false;
+
+    for (const auto &section : codes)
+    {
+        any_datetime = any_datetime || section.is_datetime;
+        any_timedelta = any_timedelta || section.is_timedelta;
+    }
+
+    is_date_format = any_datetime && !any_timedelta;
+}
+
+number_format_cache::~number_format_cache()
+{
+    delete compiled_.load();
+}
+
+const compiled_number_format &number_format_cache::get(const std::string &format_string)
+{
+    auto compiled = compiled_.load(std::memory_order_acquire);
+
+    if (compiled == nullptr)
+    {
+        // threads racing to fill the cache each parse, and all but the first discard theirs
+        std::unique_ptr<compiled_number_format> parsed(new compiled_number_format(format_string));
+        const compiled_number_format *expected = nullptr;
+
+        if (compiled_.compare_exchange_strong(expected, parsed.get(),
+                std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            compiled = parsed.release();
+        }
+        else
+        {
+            compiled = expected;
+        }
+    }
+
+    return *compiled;
+}
+
 number_formatter::number_formatter(const std::string &format_string, xyxlnt::calendar calendar)
-    : parser_(format_string), calendar_(calendar)
+    : parsed_(compiled_number_format(format_string).codes),
+      format_(parsed_),
+      calendar_(calendar)
 {
-    parser_.parse();
-    format_ = parser_.result();
 }
 
-std::string number_formatter::format_number(double number)
+number_formatter::number_formatter(const std::vector<format_code> &format, xyxlnt::calendar calendar)
+    : format_(format),
+      calendar_(calendar)
+{
+}
+
+const format_code *number_formatter::section_for(double &number) const
 {
     if (format_[0].has_condition)
     {
         if (format_[0].condition.satisfied_by(number))
         {
-            return format_number(format_[0], number);
+            return &format_[0];
         }
 
         if (format_.size() == 1)
         {
-            return std::string(11, '#');
+            return nullptr;
         }
 
         if (!format_[1].has_condition || format_[1].condition.satisfied_by(number))
         {
-            return format_number(format_[1], number);
+            return &format_[1];
         }
 
         if (format_.size() == 2)
         {
-            return std::string(11, '#');
+            return nullptr;
         }
 
-        return format_number(format_[2], number);
+        return &format_[2];
     }
 
     // no conditions, format based on sign:
@@ -1516,18 +1679,19 @@ std::string number_formatter::format_number(double number)
     // 1 section, use for all
     if (format_.size() == 1)
     {
-        return format_number(format_[0], number);
+        return &format_[0];
     }
     // 2 sections, first for positive and zero, second for negative
     else if (format_.size() == 2)
     {
         if (number >= 0)
         {
-            return format_number(format_[0], number);
+            return &format_[0];
         }
         else
         {
-            return format_number(format_[1], std::fabs(number));
+            number = std::fabs(number);
+            return &format_[1];
         }
     }
     // 3+ sections, first for positive, second for negative, third for zero
@@ -1535,15 +1699,196 @@ std::string number_formatter::format_number(double number)
     {
         if (number > 0)
         {
-            return format_number(format_[0], number);
+            return &format_[0];
         }
         else if (number < 0)
         {
-            return format_number(format_[1], std::fabs(number));
+            number = std::fabs(number);
+            return &format_[1];
+        }
+        else
+        {
+            return &format_[2];
+        }
+    }
+}
+
+std::string number_formatter::format_number(double number)
+{
+    auto section = section_for(number);
+
+    if (section == nullptr)
+    {
+        return std::string(11, '#');
+    }
+
+    return format_number(*section, number);
+}
+
+void number_formatter::format_numbers(const double *numbers, std::size_t count, formatted_numbers &output)
+{
+    std::vector<section_kind> kinds;
+    kinds.reserve(format_.size());
+
+    for (const auto &section : format_)
+    {
+        kinds.push_back(classify(section));
+    }
+
+    if (output.offsets.empty())
+    {
+        output.offsets.push_back(output.text.size());
+    }
+
+    output.offsets.reserve(output.offsets.size() + count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto number = numbers[i];
+        auto section = section_for(number);
+
+        if (section == nullptr)
+        {
+            output.text.append(11, '#');
         }
         else
         {
-            return format_number(format_[2], number);
+            switch (kinds[static_cast<std::size_t>(section - format_.data())])
+            {
+            case section_kind::numeric:
+                append_numeric(*section, number, output.text);
+                break;
+            case section_kind::date_time:
+                append_date_time(*section, number, output.text);
+                break;
+            case section_kind::other:
+                output.text.append(format_number(*section, number));
+                break;
+            }
+        }
+
+        output.offsets.push_back(output.text.size());
+    }
+}
+
+void number_formatter::append_numeric(const format_code &format, double number, std::string &result)
+{
+    // the same steps format_number takes for sections classify accepts as numeric
+    if (number < 0)
+    {
+        result.push_back('-');
+    }
+
+    number = std::fabs(number);
+
+    for (const auto &part : format.parts)
+    {
+        switch (part.type)
+        {
+        case template_part::template_type::text:
+            result.append(part.string);
+            break;
+        case template_part::template_type::space:
+            result.push_back(' ');
+            break;
+        default:
+            append_placeholders(part.placeholders, number, result);
+            break;
+        }
+    }
+}
+
+void number_formatter::append_date_time(const format_code &format, double number, std::string &result)
+{
+    // the same steps format_number takes for sections classify accepts as dates
+    if (number < 0)
+    {
+        result.append(11, '#');
+        return;
+    }
+
+    xyxlnt::datetime dt(0, 1, 0);
+
+    if (number != 0.0)
+    {
+        dt = xyxlnt::datetime::from_number(number, calendar_);
+    }
+
+    auto hour = static_cast<std::size_t>(dt.hour);
+
+    if (format.twelve_hour)
+    {
+        hour %= 12;
+
+        if (hour == 0)
+        {
+            hour = 12;
+        }
+    }
+
+    const auto second = dt.second + (dt.microsecond > 500000 ? 1 : 0);
+
+    auto append_two_digits = [&result](int value) {
+        if (value < 10)
+        {
+            result.push_back('0');
+        }
+
+        append_integer(value, result);
+    };
+
+    for (const auto &part : format.parts)
+    {
+        switch (part.type)
+        {
+        case template_part::template_type::text:
+            result.append(part.string);
+            break;
+        case template_part::template_type::space:
+            result.push_back(' ');
+            break;
+        case template_part::template_type::day_number:
+            append_integer(dt.day, result);
+            break;
+        case template_part::template_type::day_number_leading_zero:
+            append_two_digits(dt.day);
+            break;
+        case template_part::template_type::month_number:
+            append_integer(dt.month, result);
+            break;
+        case template_part::template_type::month_number_leading_zero:
+            append_two_digits(dt.month);
+            break;
+        case template_part::template_type::year_short:
+            append_two_digits(dt.year % 1000);
+            break;
+        case template_part::template_type::year_long:
+            append_integer(dt.year, result);
+            break;
+        case template_part::template_type::hour:
+            append_unsigned(hour, result);
+            break;
+        case template_part::template_type::hour_leading_zero:
+            if (hour < 10)
+            {
+                result.push_back('0');
+            }
+            append_unsigned(hour, result);
+            break;
+        case template_part::template_type::minute:
+            append_integer(dt.minute, result);
+            break;
+        case template_part::template_type::minute_leading_zero:
+            append_two_digits(dt.minute);
+            break;
+        case template_part::template_type::second:
+            append_integer(second, result);
+            break;
+        case template_part::template_type::second_leading_zero:
+            append_two_digits(second);
+            break;
+        default:
+            break;
         }
     }
 }
@@ -1566,20 +1911,30 @@ std::string number_formatter::format_text(const std::string &text)
 std::string number_formatter::fill_placeholders(const format_placeholders &p, double number)
 {
     std::string result;
+    append_placeholders(p, number, result);
+
+    return result;
+}
+
+void number_formatter::append_placeholders(const format_placeholders &p, double number, std::string &result)
+{
+    // large enough for "%f" of any double
+    char buffer[400];
 
     if (p.type == format_placeholders::placeholders_type::general
         || p.type == format_placeholders::placeholders_type::text)
     {
-        auto s = serialiser_.serialise_short(number);
-        while (s.size() > 1 && s.back() == '0')
+        auto length = serialiser_.serialise_short(number, buffer, sizeof(buffer));
+        while (length > 1 && buffer[length - 1] == '0')
         {
-            s.pop_back();
+            --length;
         }
-        if (s.back() == '.')
+        if (buffer[length - 1] == '.')
         {
-            s.pop_back();
+            --length;
         }
-        return s;
+        result.append(buffer, length);
+        return;
     }
 
     if (p.percentage)
@@ -1598,34 +1953,26 @@ std::string number_formatter::fill_placeholders(const format_placeholders &p, do
         || p.type == format_placeholders::placeholders_type::integer_part
         || p.type == format_placeholders::placeholders_type::fraction_integer)
     {
-        result = std::to_string(integer_part);
+        auto digits_end = buffer + sizeof(buffer);
+        auto digits = append_integer(integer_part, buffer, digits_end);
+        const auto digit_count = static_cast<std::size_t>(digits_end - digits);
 
-        while (result.size() < p.num_zeros)
-        {
-            result = "0" + result;
-        }
+        // left padded with zeros to num_zeros and then with spaces to num_zeros + num_spaces
+        const auto zeros = digit_count < p.num_zeros ? p.num_zeros - digit_count : 0;
+        const auto spaces = digit_count + zeros < p.num_zeros + p.num_spaces
+            ? p.num_zeros + p.num_spaces - digit_count - zeros
+            : 0;
+        const auto length = spaces + zeros + digit_count;
 
-        while (result.size() < p.num_zeros + p.num_spaces)
+        for (std::size_t i = 0; i < length; ++i)
         {
-            result = " " + result;
-        }
-
-        if (p.use_comma_separator)
-        {
-            std::vector<char> digits(result.rbegin(), result.rend());
-            std::string temp;
-
-            for (std::size_t i = 0; i < digits.size(); i++)
+            // a separator goes before every character that is a multiple of three from the end
+            if (p.use_comma_separator && (length - 1 - i) % 3 == 2)
             {
-                temp.push_back(digits[i]);
-
-                if (i % 3 == 2)
-                {
-                    temp.push_back(',');
-                }
+                result.push_back(',');
             }
 
-            result = std::string(temp.rbegin(), temp.rend());
+            result.push_back(i < spaces ? ' ' : i < spaces + zeros ? '0' : digits[i - spaces - zeros]);
         }
 
         if (p.percentage && p.type == format_placeholders::placeholders_type::integer_only)
@@ -1636,24 +1983,34 @@ std::string number_formatter::fill_placeholders(const format_placeholders &p, do
     else if (p.type == format_placeholders::placeholders_type::fractional_part)
     {
         auto fractional_part = number - integer_part;
-        result = std::fabs(fractional_part) < std::numeric_limits<double>::min()
-            ? std::string(".")
-            : serialiser_.serialise_short(fractional_part).substr(1);
+        const char *fraction = ".";
+        std::size_t length = 1;
+
+        if (std::fabs(fractional_part) >= std::numeric_limits<double>::min())
+        {
+            // drop the leading zero
+            fraction = buffer + 1;
+            length = serialiser_.serialise_short(fractional_part, buffer, sizeof(buffer)) - 1;
+        }
+
+        const auto width = p.num_zeros + p.num_optionals + p.num_spaces + 1;
 
-        while (result.back() == '0' || result.size() > (p.num_zeros + p.num_optionals + p.num_spaces + 1))
+        while (length > 0 && (fraction[length - 1] == '0' || length > width))
         {
-            result.pop_back();
+            --length;
         }
 
-        
-        if (result.size() < p.num_zeros + 1)
+        result.append(fraction, length);
+
+        if (length < p.num_zeros + 1)
         {
-            result.resize(p.num_zeros + 1, '0');
+            result.append(p.num_zeros + 1 - length, '0');
+            length = p.num_zeros + 1;
         }
 
-        if (result.size() < p.num_zeros + p.num_optionals + p.num_spaces + 1)
+        if (length < width)
         {
-            result.resize(p.num_zeros + p.num_optionals + p.num_spaces + 1, ' ');
+            result.append(width - length, ' ');
         }
 
         if (p.percentage)
@@ -1661,8 +2018,6 @@ std::string number_formatter::fill_placeholders(const format_placeholders &p, do
             result.push_back('%');
         }
     }
-
-    return result;
 }
 
 std::string number_formatter::fill_scientific_placeholders(const format_placeholders &integer_part,
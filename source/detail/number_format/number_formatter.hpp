@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -674,15 +675,85 @@ private:
     std::vector<format_code> codes_;
 };
 
+/// <summary>
+/// The parsed sections of a format string and the properties derived from them.
+/// </summary>
+struct compiled_number_format
+{
+    compiled_number_format(const std::string &format_string);
+
+    std::vector<format_code> codes;
+    bool is_date_format = false;
+};
+
+/// <summary>
+/// Holds the compiled form of a number_format's format string, parsed on first use.
+/// Copies of a number_format share one cache, so formats stored in a stylesheet are
+/// parsed once however many cells use them. Filling the cache is thread-safe.
+/// </summary>
+class number_format_cache
+{
+public:
+    number_format_cache() = default;
+    number_format_cache(const number_format_cache &) = delete;
+    number_format_cache &operator=(const number_format_cache &) = delete;
+    ~number_format_cache();
+
+    const compiled_number_format &get(const std::string &format_string);
+
+private:
+    std::atomic<const compiled_number_format *> compiled_{nullptr};
+};
+
+/// <summary>
+/// The text of several formatted values stored back to back in one buffer. The text
+/// of value i is text.substr(offsets[i], offsets[i + 1] - offsets[i]).
+/// </summary>
+struct formatted_numbers
+{
+    std::string text;
+    std::vector<std::size_t> offsets;
+
+    std::size_t size() const
+    {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    std::string at(std::size_t index) const
+    {
+        return text.substr(offsets.at(index), offsets.at(index + 1) - offsets.at(index));
+    }
+
+    void clear()
+    {
+        text.clear();
+        offsets.clear();
+    }
+};
+
 class XYXLNT_API number_formatter
 {
 public:
     number_formatter(const std::string &format_string, xyxlnt::calendar calendar);
+    number_formatter(const std::vector<format_code> &format, xyxlnt::calendar calendar);
+    number_formatter(const number_formatter &) = delete;
+    number_formatter &operator=(const number_formatter &) = delete;
     std::string format_number(double number);
     std::string format_text(const std::string &text);
 
+    /// <summary>
+    /// Appends the formatted text of count numbers to output, giving the same text as
+    /// format_number for each. Numeric and simple date sections are written straight
+    /// into the buffer with no allocation per value.
+    /// </summary>
+    void format_numbers(const double *numbers, std::size_t count, formatted_numbers &output);
+
 private:
+    const format_code *section_for(double &number) const;
     std::string fill_placeholders(const format_placeholders &p, double number);
+    void append_placeholders(const format_placeholders &p, double number, std::string &result);
+    void append_numeric(const format_code &format, double number, std::string &result);
+    void append_date_time(const format_code &format, double number, std::string &result);
     std::string fill_fraction_placeholders(const format_placeholders &numerator,
         const format_placeholders &denominator, double number, bool improper);
     std::string fill_scientific_placeholders(const format_placeholders &integer_part,
@@ -691,8 +762,8 @@ private:
     std::string format_number(const format_code &format, double number);
     std::string format_text(const format_code &format, const std::string &text);
 
-    number_format_parser parser_;
-    std::vector<format_code> format_;
+    std::vector<format_code> parsed_;
+    const std::vector<format_code> &format_;
     xyxlnt::calendar calendar_;
     xyxlnt::detail::number_serialiser serialiser_;
 };
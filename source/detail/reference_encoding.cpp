@@ -0,0 +1,138 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include <xyxlnt/cell/cell_reference.hpp>
+#include <detail/reference_encoding.hpp>
+
+namespace {
+
+// The number of columns Excel allows, A to XFD
+const std::size_t table_columns = 16384;
+
+struct column_name
+{
+    char letters[3];
+    std::uint8_t length;
+};
+
+std::size_t compute_column(std::uint32_t column, char *buffer)
+{
+    char letters[7];
+    auto end = letters + sizeof(letters);
+    auto first = end;
+
+    while (column > 0)
+    {
+        // bijective base 26: there is no zero digit, Z is 26
+        const auto remainder = (column - 1) % 26;
+        *--first = static_cast<char>('A' + remainder);
+        column = (column - 1) / 26;
+    }
+
+    std::copy(first, end, buffer);
+
+    return static_cast<std::size_t>(end - first);
+}
+
+const std::array<column_name, table_columns + 1> &column_names()
+{
+    static const auto names = []() {
+        std::array<column_name, table_columns + 1> table{};
+
+        for (std::uint32_t column = 1; column <= table_columns; ++column)
+        {
+            table[column].length = static_cast<std::uint8_t>(compute_column(column, table[column].letters));
+        }
+
+        return table;
+    }();
+
+    return names;
+}
+
+std::size_t encode_row(xyxlnt::row_t row, char *buffer)
+{
+    char digits[10];
+    auto end = digits + sizeof(digits);
+    auto first = end;
+
+    do
+    {
+        *--first = static_cast<char>('0' + row % 10);
+        row /= 10;
+    } while (row != 0);
+
+    std::copy(first, end, buffer);
+
+    return static_cast<std::size_t>(end - first);
+}
+
+} // namespace
+
+namespace xyxlnt {
+namespace detail {
+
+std::size_t encode_column(column_t::index_t column, char *buffer)
+{
+    if (column > table_columns)
+    {
+        return compute_column(column, buffer);
+    }
+
+    const auto &name = column_names()[column];
+    std::copy(name.letters, name.letters + name.length, buffer);
+
+    return name.length;
+}
+
+std::size_t encode_cell_reference(column_t::index_t column, row_t row, char *buffer)
+{
+    const auto length = encode_column(column, buffer);
+    return length + encode_row(row, buffer + length);
+}
+
+std::size_t encode_cell_reference(const cell_reference &reference, char *buffer)
+{
+    std::size_t length = 0;
+
+    if (reference.column_absolute())
+    {
+        buffer[length++] = '$';
+    }
+
+    length += encode_column(reference.column_index(), buffer + length);
+
+    if (reference.row_absolute())
+    {
+        buffer[length++] = '$';
+    }
+
+    return length + encode_row(reference.row(), buffer + length);
+}
+
+} // namespace detail
+} // namespace xyxlnt
@@ -0,0 +1,63 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+
+#include <xyxlnt/cell/index_types.hpp>
+
+namespace xyxlnt {
+
+class cell_reference;
+
+namespace detail {
+
+/// <summary>
+/// The longest text encode_cell_reference writes: two dollar signs, the seven letters
+/// of the largest column index and the ten digits of the largest row.
+/// </summary>
+const std::size_t max_cell_reference_length = 19;
+
+/// <summary>
+/// Writes the letters of column (A for 1) to buffer, which must have room for seven
+/// characters, and returns how many were written. Columns A to XFD come from a table
+/// built once. The index is not validated.
+/// </summary>
+std::size_t encode_column(column_t::index_t column, char *buffer);
+
+/// <summary>
+/// Writes the relative reference of the cell at column and row (e.g. "B12") to buffer,
+/// which must have room for max_cell_reference_length characters, and returns how many
+/// were written.
+/// </summary>
+std::size_t encode_cell_reference(column_t::index_t column, row_t row, char *buffer);
+
+/// <summary>
+/// Writes the same text as reference.to_string() to buffer, which must have room for
+/// max_cell_reference_length characters, and returns how many were written.
+/// </summary>
+std::size_t encode_cell_reference(const cell_reference &reference, char *buffer);
+
+} // namespace detail
+} // namespace xyxlnt
@@ -0,0 +1,167 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include <xyxlnt/utils/calendar.hpp>
+
+namespace xyxlnt {
+namespace detail {
+
+// Serial day 60 is 1900-02-29, a day that only exists in Excel's calendar
+const int excel_leap_day = 60;
+
+// Days from 1899-12-30, the origin of serial dates after the leap day, to 1970-01-01
+const int serial_epoch_offset = 25569;
+
+// Days from 1900-01-00 to 1904-01-01, the origin of the mac calendar
+const int mac_1904_offset = 1462;
+
+/// <summary>
+/// Converts a count of days since 1970-01-01 into a proleptic Gregorian year, month and day.
+/// Only divisions by constants and no loops or table lookups, so it inlines into batch loops.
+/// See http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+/// </summary>
+inline void civil_from_days(int days, int &year, int &month, int &day)
+{
+    days += 719468;
+    const int era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto day_of_era = static_cast<unsigned>(days - era * 146097);
+    const auto year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const auto day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const auto shifted_month = (5 * day_of_year + 2) / 153; // 0 is March
+
+    day = static_cast<int>(day_of_year - (153 * shifted_month + 2) / 5 + 1);
+    month = static_cast<int>(shifted_month < 10 ? shifted_month + 3 : shifted_month - 9);
+    year = static_cast<int>(year_of_era) + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+/// <summary>
+/// The inverse of civil_from_days.
+/// See http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+/// </summary>
+inline int days_from_civil(int year, int month, int day)
+{
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const auto year_of_era = static_cast<unsigned>(year - era * 400);
+    const auto day_of_year = static_cast<unsigned>((153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1);
+    const auto day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+
+    return era * 146097 + static_cast<int>(day_of_era) - 719468;
+}
+
+/// <summary>
+/// Converts a serial day number into a year, month and day the way Excel does,
+/// including the nonexistent 1900-02-29.
+/// </summary>
+inline void date_from_serial(int serial, calendar base_date, int &year, int &month, int &day)
+{
+    serial += base_date == calendar::mac_1904 ? mac_1904_offset : 0;
+
+    // days before the leap day are counted from 1899-12-31
+    civil_from_days(serial + (serial < excel_leap_day ? 1 : 0) - serial_epoch_offset, year, month, day);
+
+    if (serial == excel_leap_day)
+    {
+        year = 1900;
+        month = 2;
+        day = 29;
+    }
+}
+
+/// <summary>
+/// The inverse of date_from_serial.
+/// </summary>
+inline int serial_from_date(int year, int month, int day, calendar base_date)
+{
+    if (day == 29 && month == 2 && year == 1900)
+    {
+        return excel_leap_day;
+    }
+
+    auto serial = days_from_civil(year, month, day) + serial_epoch_offset;
+    serial -= serial <= excel_leap_day ? 1 : 0;
+
+    return base_date == calendar::mac_1904 ? serial - mac_1904_offset : serial;
+}
+
+/// <summary>
+/// Splits the fractional part of number into a time of day, rounding a microsecond
+/// count that is within half a microsecond of the next second up.
+/// </summary>
+inline void time_from_serial(double number, int &hour, int &minute, int &second, int &microsecond)
+{
+    double integer_part;
+    double fractional_part = std::modf(number, &integer_part);
+
+    fractional_part *= 24;
+    hour = static_cast<int>(fractional_part);
+    fractional_part = 60 * (fractional_part - hour);
+    minute = static_cast<int>(fractional_part);
+    fractional_part = 60 * (fractional_part - minute);
+    second = static_cast<int>(fractional_part);
+    fractional_part = 1000000 * (fractional_part - second);
+    microsecond = static_cast<int>(fractional_part);
+
+    if (microsecond == 999999 && fractional_part - microsecond > 0.5)
+    {
+        microsecond = 0;
+        second += 1;
+
+        if (second == 60)
+        {
+            second = 0;
+            minute += 1;
+
+            if (minute == 60)
+            {
+                minute = 0;
+                hour += 1;
+            }
+        }
+    }
+}
+
+/// <summary>
+/// Returns the fraction of a day represented by the given time, rounded to 1e-11.
+/// </summary>
+inline double serial_from_time(int hour, int minute, int second, int microsecond)
+{
+    const auto microseconds_per_hour = static_cast<std::uint64_t>(1e6) * 60 * 60;
+
+    std::uint64_t microseconds = static_cast<std::uint64_t>(microsecond);
+    microseconds += static_cast<std::uint64_t>(second * 1e6);
+    microseconds += static_cast<std::uint64_t>(minute * 1e6 * 60);
+    microseconds += static_cast<std::uint64_t>(hour) * microseconds_per_hour;
+
+    const auto number = static_cast<double>(microseconds) / (24.0 * static_cast<double>(microseconds_per_hour));
+
+    return std::floor(number * 100e9 + 0.5) / 100e9;
+}
+
+} // namespace detail
+} // namespace xyxlnt
@@ -0,0 +1,141 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <xyxlnt/utils/exceptions.hpp>
+#include <detail/serialization/buffered_xml_writer.hpp>
+
+namespace xyxlnt {
+namespace detail {
+
+buffered_xml_writer::buffered_xml_writer(std::streambuf &destination, std::size_t capacity)
+    : destination_(destination),
+      buffer_(capacity),
+      size_(0)
+{
+}
+
+void buffered_xml_writer::integer(std::uint64_t value)
+{
+    char digits[20];
+    auto first = digits + sizeof(digits);
+
+    do
+    {
+        *--first = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    markup(first, static_cast<std::size_t>(digits + sizeof(digits) - first));
+}
+
+void buffered_xml_writer::number(double value)
+{
+    char digits[32];
+    markup(digits, serialiser_.serialise(value, digits, sizeof(digits)));
+}
+
+void buffered_xml_writer::text(const std::string &value)
+{
+    escape(value, false);
+}
+
+void buffered_xml_writer::attribute_value(const std::string &value)
+{
+    escape(value, true);
+}
+
+void buffered_xml_writer::escape(const std::string &value, bool attribute)
+{
+    const auto data = value.data();
+    const auto size = value.size();
+    std::size_t run_start = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const auto c = static_cast<unsigned char>(data[i]);
+
+        // everything that needs attention is ASCII punctuation or a control character
+        if (c > '>') continue;
+
+        const char *replacement = nullptr;
+
+        switch (c)
+        {
+        case '&':
+            replacement = "&amp;";
+            break;
+        case '<':
+            replacement = "&lt;";
+            break;
+        case '>':
+            replacement = attribute ? nullptr : "&gt;";
+            break;
+        case '"':
+            replacement = attribute ? "&quot;" : nullptr;
+            break;
+        case '\r':
+            replacement = "&#xD;";
+            break;
+        case '\n':
+            replacement = attribute ? "&#xA;" : nullptr;
+            break;
+        case '\t':
+            replacement = attribute ? "&#x9;" : nullptr;
+            break;
+        default:
+            if (c < 0x20)
+            {
+                throw illegal_character(static_cast<char>(c));
+            }
+            break;
+        }
+
+        if (replacement == nullptr) continue;
+
+        markup(data + run_start, i - run_start);
+        markup(replacement, std::strlen(replacement));
+        run_start = i + 1;
+    }
+
+    markup(data + run_start, size - run_start);
+}
+
+void buffered_xml_writer::flush()
+{
+    send(buffer_.data(), size_);
+    size_ = 0;
+}
+
+void buffered_xml_writer::send(const char *data, std::size_t size)
+{
+    if (size == 0) return;
+
+    if (destination_.sputn(data, static_cast<std::streamsize>(size)) != static_cast<std::streamsize>(size))
+    {
+        throw xyxlnt::exception("failed to write XML to the output stream");
+    }
+}
+
+} // namespace detail
+} // namespace xyxlnt
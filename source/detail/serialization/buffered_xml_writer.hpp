@@ -0,0 +1,133 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <xyxlnt/utils/numeric.hpp>
+
+namespace xyxlnt {
+namespace detail {
+
+/// <summary>
+/// Appends markup that is already known to be well-formed, escaped text and numbers
+/// to a fixed buffer which is handed to a streambuf in large blocks. Unlike xml::serializer
+/// it tracks no elements or namespaces, so the caller is responsible for nesting.
+/// Used for sheetData, which makes up almost all of a worksheet part.
+/// </summary>
+class buffered_xml_writer
+{
+public:
+    /// <summary>
+    /// Constructs a writer that sends its output to destination whenever more than
+    /// capacity bytes are waiting.
+    /// </summary>
+    explicit buffered_xml_writer(std::streambuf &destination, std::size_t capacity = 65536);
+
+    buffered_xml_writer(const buffered_xml_writer &) = delete;
+    buffered_xml_writer &operator=(const buffered_xml_writer &) = delete;
+
+    /// <summary>
+    /// Appends size bytes of markup without escaping them.
+    /// </summary>
+    void markup(const char *data, std::size_t size)
+    {
+        if (size > buffer_.size() - size_)
+        {
+            flush();
+
+            if (size > buffer_.size())
+            {
+                send(data, size);
+                return;
+            }
+        }
+
+        std::memcpy(buffer_.data() + size_, data, size);
+        size_ += size;
+    }
+
+    /// <summary>
+    /// Appends a string literal of markup, e.g. markup("</c>").
+    /// </summary>
+    template <std::size_t N>
+    void markup(const char (&literal)[N])
+    {
+        markup(literal, N - 1);
+    }
+
+    /// <summary>
+    /// Appends a string of markup without escaping it.
+    /// </summary>
+    void markup(const std::string &data)
+    {
+        markup(data.data(), data.size());
+    }
+
+    /// <summary>
+    /// Appends the decimal digits of value.
+    /// </summary>
+    void integer(std::uint64_t value);
+
+    /// <summary>
+    /// Appends value as number_serialiser::serialise formats it.
+    /// </summary>
+    void number(double value);
+
+    /// <summary>
+    /// Appends value as element content, escaping the characters that xml::serializer escapes.
+    /// Throws illegal_character if value contains a control character XML can't represent.
+    /// </summary>
+    void text(const std::string &value);
+
+    /// <summary>
+    /// Appends value as the inside of a double-quoted attribute value.
+    /// Throws illegal_character if value contains a control character XML can't represent.
+    /// </summary>
+    void attribute_value(const std::string &value);
+
+    /// <summary>
+    /// Sends everything appended so far to the destination.
+    /// </summary>
+    void flush();
+
+private:
+    void escape(const std::string &value, bool attribute);
+
+    void send(const char *data, std::size_t size);
+
+    std::streambuf &destination_;
+    std::vector<char> buffer_;
+    std::size_t size_;
+    number_serialiser serialiser_;
+};
+
+} // namespace detail
+} // namespace xyxlnt
@@ -0,0 +1,189 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+
+#include <xyxlnt/utils/path.hpp>
+#include <detail/serialization/serialization_profiler.hpp>
+
+namespace xyxlnt {
+namespace detail {
+
+/// <summary>
+/// Buffers reads from and writes to the streambuf of an archive part, timing each
+/// exchange with it as compression and counting the bytes written. Parts being read
+/// often aren't read to the end, so their sizes are taken from the archive instead.
+/// </summary>
+class profiled_streambuf : public std::streambuf
+{
+public:
+    profiled_streambuf(serialization_profiler &profiler, std::size_t index, std::unique_ptr<std::streambuf> inner)
+        : profiler_(profiler),
+          index_(index),
+          inner_(std::move(inner)),
+          buffer_(buffer_size)
+    {
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+
+    ~profiled_streambuf() override
+    {
+        flush();
+
+        // finishing the compressed stream happens here
+        const auto start = serialization_profiler::clock::now();
+        inner_.reset();
+        part().compression_duration += serialization_profiler::clock::now() - start;
+
+        profiler_.close_part(index_);
+    }
+
+private:
+    static const std::size_t buffer_size = 16384;
+
+    part_profile &part()
+    {
+        return profiler_.profile_.parts[index_];
+    }
+
+    int_type underflow() override
+    {
+        const auto start = serialization_profiler::clock::now();
+        const auto count = inner_->sgetn(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        part().compression_duration += serialization_profiler::clock::now() - start;
+
+        if (count <= 0)
+        {
+            return traits_type::eof();
+        }
+
+        setg(buffer_.data(), buffer_.data(), buffer_.data() + count);
+
+        return traits_type::to_int_type(*gptr());
+    }
+
+    int_type overflow(int_type c) override
+    {
+        if (!flush())
+        {
+            return traits_type::eof();
+        }
+
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override
+    {
+        return flush() ? 0 : -1;
+    }
+
+    bool flush()
+    {
+        const auto count = pptr() - pbase();
+
+        if (count == 0)
+        {
+            return true;
+        }
+
+        const auto start = serialization_profiler::clock::now();
+        const auto written = inner_->sputn(pbase(), count);
+        part().compression_duration += serialization_profiler::clock::now() - start;
+        part().uncompressed_bytes += static_cast<std::uint64_t>(count);
+
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+
+        return written == count;
+    }
+
+    serialization_profiler &profiler_;
+    std::size_t index_;
+    std::unique_ptr<std::streambuf> inner_;
+    std::vector<char> buffer_;
+};
+
+serialization_profiler::serialization_profiler(serialization_profile &profile)
+    : profile_(profile),
+      started_(clock::now()),
+      last_charged_(started_)
+{
+    profile_.parts.clear();
+    profile_.duration = std::chrono::nanoseconds::zero();
+}
+
+std::unique_ptr<std::streambuf> serialization_profiler::open_part(
+    const path &part, std::unique_ptr<std::streambuf> archive_streambuf)
+{
+    charge_open_part();
+
+    profile_.parts.emplace_back();
+    profile_.parts.back().part = part;
+    open_parts_.push_back(profile_.parts.size() - 1);
+
+    return std::unique_ptr<std::streambuf>(
+        new profiled_streambuf(*this, open_parts_.back(), std::move(archive_streambuf)));
+}
+
+part_profile &serialization_profiler::current_part()
+{
+    return profile_.parts[open_parts_.back()];
+}
+
+void serialization_profiler::append(const serialization_profile &other)
+{
+    profile_.parts.insert(profile_.parts.end(), other.parts.begin(), other.parts.end());
+}
+
+void serialization_profiler::finish()
+{
+    charge_open_part();
+    profile_.duration = clock::now() - started_;
+}
+
+void serialization_profiler::charge_open_part()
+{
+    const auto now = clock::now();
+
+    if (!open_parts_.empty())
+    {
+        current_part().duration += now - last_charged_;
+    }
+
+    last_charged_ = now;
+}
+
+void serialization_profiler::close_part(std::size_t index)
+{
+    charge_open_part();
+    open_parts_.erase(std::find(open_parts_.begin(), open_parts_.end(), index));
+}
+
+} // namespace detail
+} // namespace xyxlnt
@@ -0,0 +1,104 @@
+// Copyright (c) 2016-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <streambuf>
+#include <vector>
+
+#include <xyxlnt/workbook/serialization_profile.hpp>
+
+namespace xyxlnt {
+
+class path;
+
+namespace detail {
+
+/// <summary>
+/// Fills a serialization_profile for xlsx_consumer and xlsx_producer. Those only make
+/// one when a profile was requested, so nothing is measured otherwise. Parts may be
+/// opened while others are, as worksheets are read from inside the workbook part, so
+/// time is always charged to the most recently opened part that's still open.
+/// </summary>
+class serialization_profiler
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /// <summary>
+    /// Starts the clock of a load or save recorded into profile, clearing it.
+    /// </summary>
+    explicit serialization_profiler(serialization_profile &profile);
+
+    serialization_profiler(const serialization_profiler &) = delete;
+    serialization_profiler &operator=(const serialization_profiler &) = delete;
+
+    /// <summary>
+    /// Returns a streambuf which passes everything through to archive_streambuf, the
+    /// (de)compressing streambuf of part. The part is measured until it's destroyed.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open_part(const path &part, std::unique_ptr<std::streambuf> archive_streambuf);
+
+    /// <summary>
+    /// Returns the most recently opened part that's still open. The reference is only
+    /// valid until the next part is opened.
+    /// </summary>
+    part_profile &current_part();
+
+    /// <summary>
+    /// Adds the parts measured by another profiler, e.g. one on another thread.
+    /// </summary>
+    void append(const serialization_profile &other);
+
+    /// <summary>
+    /// Stops the clock of the whole load or save.
+    /// </summary>
+    void finish();
+
+private:
+    friend class profiled_streambuf;
+
+    /// <summary>
+    /// Adds the time since the last part was opened or closed to the part open now.
+    /// </summary>
+    void charge_open_part();
+
+    void close_part(std::size_t index);
+
+    serialization_profile &profile_;
+
+    /// <summary>
+    /// Indices into profile_.parts of the open parts in the order they were opened.
+    /// </summary>
+    std::vector<std::size_t> open_parts_;
+
+    clock::time_point started_;
+    clock::time_point last_charged_;
+};
+
+} // namespace detail
+} // namespace xyxlnt
@@ -42,6 +42,7 @@
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/serialization/custom_value_traits.hpp>
 #include <detail/serialization/defined_name.hpp>
+#include <detail/serialization/serialization_profiler.hpp>
 #include <detail/serialization/serialisation_helpers.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
@@ -411,8 +412,9 @@ private:
 namespace xyxlnt {
 namespace detail {
 
-xlsx_consumer::xlsx_consumer(workbook &target)
-    : target_(target),
+xlsx_consumer::xlsx_consumer(workbook &target, const load_options &options)
+    : options_(options),
+      target_(target),
       parser_(nullptr)
 {
 }
@@ -423,8 +425,18 @@ xlsx_consumer::~xlsx_consumer()
 
 void xlsx_consumer::read(std::istream &source)
 {
+    if (options_.profile != nullptr)
+    {
+        profiler_.reset(new serialization_profiler(*options_.profile));
+    }
+
     archive_.reset(new izstream(source));
     populate_workbook(false);
+
+    if (profiler_)
+    {
+        profiler_->finish();
+    }
 }
 
 void xlsx_consumer::open(std::istream &source)
@@ -445,6 +457,19 @@ void xlsx_consumer::read_worksheet(const std::string &rel_id)
     if (!streaming_)
     {
         read_worksheet_sheetdata();
+
+        if (profiler_)
+        {
+            std::uint64_t cells = 0;
+
+            for (const auto &row : current_worksheet_->cell_map_)
+            {
+                cells += row.second.size();
+            }
+
+            profiler_->current_part().cells += cells;
+        }
+
         read_worksheet_end(rel_id);
     }
 }
@@ -518,6 +543,7 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
     if (streaming_ && streaming_cell_ == nullptr)
     {
         streaming_cell_.reset(new detail::cell_impl());
+        streaming_row_.reset(new detail::row_key(1));
     }
     
     array_formulae_.clear();
@@ -845,13 +871,9 @@ void xlsx_consumer::read_worksheet_sheetdata()
     {
         current_worksheet_->row_properties_.emplace(row.second, std::move(row.first));
     }
-    auto impl = detail::cell_impl();
     for (Cell &cell : ws_data.parsed_cells)
     {
-        impl.parent_ = current_worksheet_;
-        impl.column_ = cell.ref.column;
-        impl.row_ = cell.ref.row;
-        detail::cell_impl *ws_cell_impl = &current_worksheet_->cell_map_.emplace(cell_reference(impl.column_, impl.row_), std::move(impl)).first->second;
+        detail::cell_impl *ws_cell_impl = &current_worksheet_->get_or_create_cell(cell.ref.column, cell.ref.row);
         if (cell.style_index != -1)
         {
             ws_cell_impl->format_ = target_.format(static_cast<size_t>(cell.style_index)).d_;
@@ -897,6 +919,10 @@ void xlsx_consumer::read_worksheet_sheetdata()
             }
             }
         }
+        if (ws_cell_impl->is_garbage_collectible())
+        {
+            current_worksheet_->mark_garbage_candidate(ws_cell_impl->column_, ws_cell_impl->row());
+        }
     }
     stack_.pop_back();
     
@@ -959,7 +985,13 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
             while (in_element(qn("spreadsheetml", "mergeCells")))
             {
                 expect_start_element(qn("spreadsheetml", "mergeCell"), xml::content::simple);
-                ws.merge_cells(range_reference(parser().attribute("ref")));
+                const auto merged_range = range_reference(parser().attribute("ref"));
+
+                // Excel discards overlapping merges when repairing a file, so skip them here too
+                if (!ws.d_->merged_cells_.overlaps(merged_range))
+                {
+                    ws.merge_cells(merged_range);
+                }
                 expect_end_element(qn("spreadsheetml", "mergeCell"));
             }
         }
@@ -1308,7 +1340,7 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
             manifest.relationship(sheet_path, xyxlnt::relationship_type::comments)});
 
         auto receive = xml::parser::receive_default;
-        auto comments_part_streambuf = archive_->open(comments_part);
+        auto comments_part_streambuf = open_part(comments_part);
         std::istream comments_part_stream(comments_part_streambuf.get());
         xml::parser parser(comments_part_stream, comments_part.string(), receive);
         parser_ = &parser;
@@ -1335,7 +1367,7 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
             manifest.relationship(sheet_path, xyxlnt::relationship_type::drawings)});
 
         auto receive = xml::parser::receive_default;
-        auto drawings_part_streambuf = archive_->open(drawings_part);
+        auto drawings_part_streambuf = open_part(drawings_part);
         std::istream drawings_part_stream(drawings_part_streambuf.get());
         xml::parser parser(drawings_part_stream, drawings_part.string(), receive);
         parser_ = &parser;
@@ -1441,7 +1473,8 @@ bool xlsx_consumer::has_cell()
     auto reference = cell_reference(parser().attribute("r"));
     cell.d_->parent_ = current_worksheet_;
     cell.d_->column_ = reference.column_index();
-    cell.d_->row_ = reference.row();
+    streaming_row_->index = reference.row();
+    cell.d_->row_ = streaming_row_.get();
 
     if (parser().attribute_present("ph"))
     {
@@ -1585,7 +1618,7 @@ std::vector<relationship> xlsx_consumer::read_relationships(const path &part)
     std::vector<xyxlnt::relationship> relationships;
     if (!archive_->has_file(part_rels_path)) return relationships;
 
-    auto rels_streambuf = archive_->open(part_rels_path);
+    auto rels_streambuf = open_part(part_rels_path);
     std::istream rels_stream(rels_streambuf.get());
     xml::parser parser(rels_stream, part_rels_path.string());
     parser_ = &parser;
@@ -1623,7 +1656,7 @@ void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
 {
     const auto &manifest = target_.manifest();
     const auto part_path = manifest.canonicalize(rel_chain);
-    auto part_streambuf = archive_->open(part_path);
+    auto part_streambuf = open_part(part_path);
     std::istream part_stream(part_streambuf.get());
     xml::parser parser(part_stream, part_path.string());
     parser_ = &parser;
@@ -1766,6 +1799,11 @@ void xlsx_consumer::populate_workbook(bool streaming)
 
     target_.clear();
 
+    // cells are filled in directly while reading, so their shared strings are counted and
+    // the cells with references found on demand
+    target_.d_->invalidate_shared_string_references();
+    target_.d_->invalidate_reference_cells();
+
     read_content_types();
     const auto root_path = path("/");
 
@@ -1802,7 +1840,7 @@ void xlsx_consumer::populate_workbook(bool streaming)
 void xlsx_consumer::read_content_types()
 {
     auto &manifest = target_.manifest();
-    auto content_types_streambuf = archive_->open(path("[Content_Types].xml"));
+    auto content_types_streambuf = open_part(path("[Content_Types].xml"));
     std::istream content_types_stream(content_types_streambuf.get());
     xml::parser parser(content_types_stream, "[Content_Types].xml");
     parser_ = &parser;
@@ -3080,7 +3118,7 @@ void xlsx_consumer::read_unknown_relationships()
 
 void xlsx_consumer::read_image(const xyxlnt::path &image_path)
 {
-    auto image_streambuf = archive_->open(image_path);
+    auto image_streambuf = open_part(image_path);
     vector_ostreambuf buffer(target_.d_->images_[image_path.string()]);
     std::ostream out_stream(&buffer);
     out_stream << image_streambuf.get();
@@ -3088,7 +3126,7 @@ void xlsx_consumer::read_image(const xyxlnt::path &image_path)
 
 void xlsx_consumer::read_binary(const xyxlnt::path &binary_path)
 {
-    auto binary_streambuf = archive_->open(binary_path);
+    auto binary_streambuf = open_part(binary_path);
     vector_ostreambuf buffer(target_.d_->binaries_[binary_path.string()]);
     std::ostream out_stream(&buffer);
     out_stream << binary_streambuf.get();
@@ -3459,5 +3497,22 @@ manifest &xlsx_consumer::manifest()
     return target_.manifest();
 }
 
+std::unique_ptr<std::streambuf> xlsx_consumer::open_part(const path &part)
+{
+    auto part_streambuf = archive_->open(part);
+
+    if (!profiler_)
+    {
+        return part_streambuf;
+    }
+
+    auto profiled_streambuf = profiler_->open_part(part, std::move(part_streambuf));
+    const auto &header = archive_->header(part);
+    profiler_->current_part().compressed_bytes = header.compressed_size;
+    profiler_->current_part().uncompressed_bytes = header.uncompressed_size;
+
+    return profiled_streambuf;
+}
+
 } // namespace detail
 } // namespace xyxlnt
@@ -35,6 +35,7 @@
 #include <detail/external/include_libstudxml.hpp>
 #include <detail/serialization/zstream.hpp>
 #include <xyxlnt/utils/numeric.hpp>
+#include <xyxlnt/workbook/load_options.hpp>
 
 namespace xyxlnt {
 
@@ -55,8 +56,10 @@ class worksheet;
 namespace detail {
 
 class izstream;
+class serialization_profiler;
 struct cell_impl;
 struct defined_name;
+struct row_key;
 struct worksheet_impl;
 
 /// <summary>
@@ -65,7 +68,7 @@ struct worksheet_impl;
 class xlsx_consumer
 {
 public:
-	xlsx_consumer(workbook &destination);
+	xlsx_consumer(workbook &destination, const load_options &options = load_options());
 
 	~xlsx_consumer();
 
@@ -384,11 +387,23 @@ private:
     /// </summary>
     class manifest &manifest();
 
+    /// <summary>
+    /// Opens part in archive_ for reading, measured by profiler_ if there is one.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open_part(const path &part);
+
 	/// <summary>
 	/// The ZIP file containing the files that make up the OOXML package.
 	/// </summary>
 	std::unique_ptr<izstream> archive_;
 
+    load_options options_;
+
+    /// <summary>
+    /// Measures a load into options_.profile. Null when no profile was requested.
+    /// </summary>
+    std::unique_ptr<serialization_profiler> profiler_;
+
 	/// <summary>
 	/// Map of sheet titles to relationship IDs.
 	/// </summary>
@@ -419,6 +434,11 @@ private:
     bool streaming_ = false;
 
     std::unique_ptr<detail::cell_impl> streaming_cell_;
+
+    /// <summary>
+    /// The row of streaming_cell_, which isn't stored in a worksheet row.
+    /// </summary>
+    std::unique_ptr<detail::row_key> streaming_row_;
     
     std::unordered_map<int, std::string> shared_formulae_;
     std::unordered_map<std::string, std::string> array_formulae_;
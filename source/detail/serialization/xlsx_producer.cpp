@@ -21,9 +21,12 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <atomic>
 #include <cmath>
+#include <exception>
 #include <numeric> // for std::accumulate
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <unordered_set>
 
@@ -40,8 +43,11 @@
 #include <detail/constants.hpp>
 #include <detail/header_footer/header_footer_code.hpp>
 #include <detail/implementations/workbook_impl.hpp>
+#include <detail/reference_encoding.hpp>
+#include <detail/serialization/buffered_xml_writer.hpp>
 #include <detail/serialization/custom_value_traits.hpp>
 #include <detail/serialization/defined_name.hpp>
+#include <detail/serialization/serialization_profiler.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_producer.hpp>
 #include <detail/serialization/zstream.hpp>
@@ -80,12 +86,16 @@ std::vector<std::pair<std::string, std::string>> core_property_namespace(xyxlnt:
 namespace xyxlnt {
 namespace detail {
 
-xlsx_producer::xlsx_producer(const workbook &target)
+xlsx_producer::xlsx_producer(const workbook &target, const save_options &options)
     : source_(target),
+      options_(options),
       current_part_stream_(nullptr),
-      current_cell_(nullptr),
       current_worksheet_(nullptr)
 {
+    if (options_.profile != nullptr)
+    {
+        profiler_.reset(new serialization_profiler(*options_.profile));
+    }
 }
 
 xlsx_producer::~xlsx_producer()
@@ -97,27 +107,196 @@ xlsx_producer::~xlsx_producer()
 void xlsx_producer::write(std::ostream &destination)
 {
     archive_.reset(new ozstream(destination));
+
+    if (options_.compact_shared_strings)
+    {
+        compact_shared_strings();
+    }
+
     populate_archive(false);
+
+    if (profiler_)
+    {
+        end_part();
+
+        // sizes are final once each part's streambuf is gone, including the detached ones
+        for (auto &part : options_.profile->parts)
+        {
+            part.compressed_bytes = archive_->header(part.part).compressed_size;
+        }
+
+        profiler_->finish();
+    }
+}
+
+void xlsx_producer::compact_shared_strings()
+{
+    auto &workbook = *source_.d_;
+    const auto &values = workbook.shared_strings_values_;
+    // finds the first of several equal strings
+    workbook.shared_strings_index_.sync(values);
+
+    const auto unused = shared_string_index::npos;
+    auto table = std::make_shared<compacted_shared_string_table>();
+    table->ids.assign(values.size(), unused);
+
+    for (const auto &ws : workbook.worksheets_)
+    {
+        for (const auto &row : ws.cell_map_)
+        {
+            for (const auto &cell : row.second)
+            {
+                if (cell.second.type_ != cell_type::shared_string) continue;
+
+                const auto index = static_cast<std::size_t>(cell.second.value_numeric_);
+
+                if (index >= values.size())
+                {
+                    throw xyxlnt::exception("shared string index out of range");
+                }
+
+                ++table->references;
+
+                if (table->ids[index] != unused) continue;
+
+                const auto first = workbook.shared_strings_index_.find(values, values[index]);
+
+                if (table->ids[first] == unused)
+                {
+                    table->ids[first] = table->strings.size();
+                    table->strings.push_back(first);
+                }
+
+                table->ids[index] = table->ids[first];
+            }
+        }
+    }
+
+    compacted_shared_strings_ = table;
+}
+
+std::size_t xlsx_producer::shared_string_id(std::size_t index) const
+{
+    return compacted_shared_strings_ ? compacted_shared_strings_->ids[index] : index;
 }
 
 void xlsx_producer::open(std::ostream &destination)
 {
     archive_.reset(new ozstream(destination));
-    populate_archive(true);
+    streaming_ = true;
+    streaming_cell_.reset(new detail::cell_impl());
+    streaming_cell_row_.reset(new detail::row_key(1));
+
+    // format ids written with streamed cells have to stay valid until the styles are written
+    source_.d_->stylesheet_.get().garbage_collection_enabled = false;
+
+    // each streamed string is dropped from the table once written
+    source_.d_->invalidate_shared_string_references();
+}
+
+void xlsx_producer::begin_worksheet(worksheet ws)
+{
+    current_worksheet_ = ws.d_;
+    *streaming_cell_ = detail::cell_impl();
+    streaming_cell_->parent_ = current_worksheet_;
+    streaming_cell_pending_ = false;
+    streaming_sheet_data_open_ = false;
+    streaming_row_ = 0;
+}
+
+void xlsx_producer::end_worksheet()
+{
+    if (current_worksheet_ == nullptr) return;
+
+    // this also begins the part if no cells were added
+    write_streaming_cell();
+
+    if (streaming_row_ != 0)
+    {
+        end_row();
+    }
+
+    end_sheet_data();
+
+    // hyperlinks and comments live in cell_impls, which aren't kept for streamed cells
+    const auto ws = worksheet(current_worksheet_);
+    write_worksheet_footer(ws, worksheet_part(ws), {}, {});
+    end_part();
+
+    current_worksheet_ = nullptr;
 }
 
 cell xlsx_producer::add_cell(const cell_reference &ref)
 {
-    current_cell_->column_ = ref.column();
-    current_cell_->row_ = ref.row();
+    if (streaming_cell_pending_)
+    {
+        const auto &previous = *streaming_cell_;
+
+        if (ref.row() < previous.row() || (ref.row() == previous.row() && ref.column() <= previous.column_))
+        {
+            throw invalid_parameter();
+        }
+
+        write_streaming_cell();
+    }
+
+    *streaming_cell_ = detail::cell_impl();
+    streaming_cell_->parent_ = current_worksheet_;
+    streaming_cell_->column_ = ref.column();
+    streaming_cell_row_->index = ref.row();
+    streaming_cell_->row_ = streaming_cell_row_.get();
+    streaming_cell_pending_ = true;
+
+    return cell(streaming_cell_.get());
+}
+
+void xlsx_producer::write_streaming_cell()
+{
+    const auto ws = worksheet(current_worksheet_);
+
+    if (!streaming_sheet_data_open_)
+    {
+        begin_part(worksheet_part(ws));
+        // the extent of the sheet isn't known until the end and dimension is optional
+        write_worksheet_header(ws, optional<range_reference>());
+        begin_sheet_data();
+        streaming_sheet_data_open_ = true;
+    }
+
+    if (!streaming_cell_pending_) return;
+
+    streaming_cell_pending_ = false;
+
+    const auto current = cell(streaming_cell_.get());
+
+    if (current.garbage_collectible()) return;
+
+    if (current.row() != streaming_row_)
+    {
+        if (streaming_row_ != 0)
+        {
+            end_row();
+        }
+
+        streaming_row_ = current.row();
+        begin_row(ws, streaming_row_, 0, 0, false);
+    }
+
+    write_cell(current);
 
-    return cell(current_cell_);
+    if (current.data_type() == cell::type::shared_string)
+    {
+        // the text was written inline so the table only needs to hold the next cell's string
+        source_.d_->shared_strings_values_.clear();
+    }
 }
 
-worksheet xlsx_producer::add_worksheet(const std::string &title)
+path xlsx_producer::worksheet_part(const worksheet &ws) const
 {
-    current_worksheet_->title_ = title;
-    return worksheet(current_worksheet_);
+    const auto workbook_part = source_.manifest().relationship(path("/"), relationship_type::office_document).target().path();
+    const auto rel = source_.manifest().relationship(workbook_part, source_.d_->sheet_title_rel_id_map_.at(ws.title()));
+
+    return rel.source().path().parent().append(rel.target().path());
 }
 
 // Part Writing Methods
@@ -170,6 +349,8 @@ void xlsx_producer::populate_archive(bool streaming)
 
 void xlsx_producer::end_part()
 {
+    sheet_data_writer_.reset();
+
     if (current_part_serializer_)
     {
         current_part_serializer_.reset();
@@ -181,7 +362,7 @@ void xlsx_producer::end_part()
 void xlsx_producer::begin_part(const path &part)
 {
     end_part();
-    current_part_streambuf_ = archive_->open(part);
+    current_part_streambuf_ = open_archive_part(part);
     current_part_stream_.rdbuf(current_part_streambuf_.get());
 
     auto xml_serializer = new xml::serializer(current_part_stream_, part.string(), 0);
@@ -189,6 +370,28 @@ void xlsx_producer::begin_part(const path &part)
     current_part_serializer_.reset(xml_serializer);
 }
 
+std::unique_ptr<std::streambuf> xlsx_producer::open_archive_part(const path &part)
+{
+    std::unique_ptr<std::streambuf> part_streambuf;
+
+    if (detached_parts_ != nullptr)
+    {
+        detached_parts_->emplace_back();
+        part_streambuf = ozstream::open_detached(part, detached_parts_->back());
+    }
+    else
+    {
+        part_streambuf = archive_->open(part);
+    }
+
+    if (profiler_)
+    {
+        return profiler_->open_part(part, std::move(part_streambuf));
+    }
+
+    return part_streambuf;
+}
+
 // Package Parts
 
 void xlsx_producer::write_content_types()
@@ -720,6 +923,8 @@ void xlsx_producer::write_workbook(const relationship &rel)
     auto workbook_rels = source_.manifest().relationships(rel.target().path());
     write_relationships(workbook_rels, rel.target().path());
 
+    auto rendered_worksheets = render_worksheets(workbook_rels);
+
     for (const auto &child_rel : workbook_rels)
     {
         if (child_rel.type() == relationship_type::calculation_chain)
@@ -732,6 +937,26 @@ void xlsx_producer::write_workbook(const relationship &rel)
             continue;
         }
 
+        if (streaming_ && child_rel.type() == relationship_type::worksheet)
+        {
+            // already written as the cells were added
+            continue;
+        }
+
+        auto rendered = rendered_worksheets.find(child_rel.id());
+
+        if (rendered != rendered_worksheets.end())
+        {
+            end_part();
+
+            for (const auto &entry : rendered->second)
+            {
+                archive_->add(entry);
+            }
+
+            continue;
+        }
+
         auto child_target_path = child_rel.target().path();
         path archive_path(child_rel.source().path().parent().append(child_target_path));
         
@@ -991,36 +1216,30 @@ void xlsx_producer::write_shared_string_table(const relationship & /*rel*/)
     write_start_element(xmlns, "sst");
     write_namespace(xmlns, "");
 
-    // todo: is there a more elegant way to get this number?
-    std::size_t string_count = 0;
+    const auto &values = source_.d_->shared_strings_values_;
 
-    for (const auto ws : source_)
+    if (compacted_shared_strings_)
     {
-        auto dimension = ws.calculate_dimension();
-        auto current_cell = dimension.top_left();
+        write_attribute("count", compacted_shared_strings_->references);
+        write_attribute("uniqueCount", compacted_shared_strings_->strings.size());
 
-        while (current_cell.row() <= dimension.bottom_right().row())
+        for (const auto index : compacted_shared_strings_->strings)
         {
-            while (current_cell.column() <= dimension.bottom_right().column())
-            {
-                auto c_iter = ws.d_->cell_map_.find(current_cell);
-                if (c_iter != ws.d_->cell_map_.end() && c_iter->second.type_ == cell_type::shared_string)
-                {
-                    ++string_count;
-                }
-
-                current_cell.column_index(current_cell.column_index() + 1);
-            }
-
-            current_cell.row(current_cell.row() + 1);
-            current_cell.column_index(dimension.top_left().column_index());
+            write_start_element(xmlns, "si");
+            write_rich_text(xmlns, values[index]);
+            write_end_element(xmlns, "si");
         }
+
+        write_end_element(xmlns, "sst");
+        return;
     }
 
-    write_attribute("count", string_count);
-    write_attribute("uniqueCount", source_.shared_strings().size());
+    // free unless the counts were invalidated, e.g. by loading, in which case every cell is visited once
+    source_.d_->count_shared_string_references();
+    write_attribute("count", source_.d_->shared_string_reference_total_);
+    write_attribute("uniqueCount", values.size());
 
-    for (const auto &text : source_.shared_strings())
+    for (const auto &text : values)
     {
         write_start_element(xmlns, "si");
         write_rich_text(xmlns, text);
@@ -2253,13 +2472,7 @@ void xlsx_producer::write_volatile_dependencies(const relationship & /*rel*/)
 
 void xlsx_producer::write_worksheet(const relationship &rel)
 {
-    static const auto &xmlns = constants::ns("spreadsheetml");
-    static const auto &xmlns_r = constants::ns("r");
-    static const auto &xmlns_mc = constants::ns("mc");
-    static const auto &xmlns_x14ac = constants::ns("x14ac");
-
     auto worksheet_part = rel.source().path().parent().append(rel.target().path());
-    auto worksheet_rels = source_.manifest().relationships(worksheet_part);
 
     auto title = std::find_if(source_.d_->sheet_title_rel_id_map_.begin(), source_.d_->sheet_title_rel_id_map_.end(),
         [&](const std::pair<std::string, std::string> &p) {
@@ -2268,22 +2481,278 @@ void xlsx_producer::write_worksheet(const relationship &rel)
 
     auto ws = source_.sheet_by_title(title);
 
+    const auto dimension = ws.calculate_dimension();
+    write_worksheet_header(ws, dimension);
+
+    std::vector<std::pair<std::string, hyperlink>> hyperlinks;
+    std::vector<cell_reference> cells_with_comments;
+
+    begin_sheet_data();
+
+    // rows are written if they have cells or properties, so both are walked in row order
+    auto &cell_map = ws.d_->cell_map_;
+    std::vector<row_t> property_rows;
+    property_rows.reserve(ws.d_->row_properties_.size());
+
+    for (const auto &properties : ws.d_->row_properties_)
+    {
+        property_rows.push_back(properties.first);
+    }
+
+    std::sort(property_rows.begin(), property_rows.end());
+
+    auto row_iter = cell_map.begin();
+    auto property_row_iter = property_rows.begin();
+
+    // See note for CT_Row, span attribute about block optimization. Blocks start at the first
+    // row and at every row after it that follows a multiple of 16, and end at the next multiple
+    // of 16 after their start.
+    const auto first_row = ws.lowest_row_or_props();
+    auto block_first_row = row_t(0);
+    auto first_block_column = constants::max_column();
+    auto last_block_column = constants::min_column();
+
+    while (row_iter != cell_map.end() || property_row_iter != property_rows.end())
+    {
+        auto row = row_iter != cell_map.end() ? row_t(row_iter->first) : constants::max_row();
+
+        if (property_row_iter != property_rows.end())
+        {
+            row = std::min(row, *property_row_iter);
+        }
+
+        const auto row_cells = row_iter != cell_map.end() && row_iter->first == row
+            ? &row_iter->second
+            : nullptr;
+
+        if (row_cells != nullptr) ++row_iter;
+        if (property_row_iter != property_rows.end() && *property_row_iter == row) ++property_row_iter;
+
+        const auto row_block_first_row = std::max(first_row, ((row - 1) / 16) * 16 + 1);
+
+        if (row_block_first_row != block_first_row)
+        {
+            block_first_row = row_block_first_row;
+            const auto block_last_row = ((block_first_row / 16) + 1) * 16;
+
+            first_block_column = constants::max_column();
+            last_block_column = constants::min_column();
+
+            for (auto block_row = cell_map.lower_bound(block_first_row);
+                 block_row != cell_map.end() && block_row->first <= block_last_row; ++block_row)
+            {
+                const auto &cells = block_row->second;
+
+                auto first_cell = std::find_if(cells.begin(), cells.end(),
+                    [](const std::pair<const detail::column_key, detail::cell_impl> &cell) {
+                        return !cell.second.is_garbage_collectible();
+                    });
+
+                if (first_cell == cells.end()) continue;
+
+                auto last_cell = std::find_if(cells.rbegin(), cells.rend(),
+                    [](const std::pair<const detail::column_key, detail::cell_impl> &cell) {
+                        return !cell.second.is_garbage_collectible();
+                    });
+
+                first_block_column = std::min(first_block_column, first_cell->second.column_);
+                last_block_column = std::max(last_block_column, last_cell->second.column_);
+            }
+        }
+
+        const auto any_non_null = row_cells != nullptr
+            && std::any_of(row_cells->begin(), row_cells->end(),
+                [](const std::pair<const detail::column_key, detail::cell_impl> &cell) {
+                    return !cell.second.is_garbage_collectible();
+                });
+
+        if (!any_non_null && !ws.has_row_properties(row)) continue;
+
+        begin_row(ws, row, first_block_column.index, last_block_column.index, !any_non_null);
+
+        if (any_non_null)
+        {
+            // the cells are read in place rather than through worksheet::cell so that saving
+            // never modifies the worksheet, which lets worksheets be rendered concurrently
+            for (auto &entry : *row_cells)
+            {
+                auto cell = xyxlnt::cell(&entry.second);
+
+                if (cell.garbage_collectible()) continue;
+
+                // record data about the cell needed later
+
+                if (cell.has_comment())
+                {
+                    cells_with_comments.push_back(cell.reference());
+                }
+
+                if (cell.has_hyperlink())
+                {
+                    hyperlinks.push_back(std::make_pair(cell.reference().to_string(), cell.hyperlink()));
+                }
+
+                write_cell(cell);
+            }
+
+            end_row();
+        }
+    }
+
+    end_sheet_data();
+
+    if (profiler_)
+    {
+        std::uint64_t cells = 0;
+
+        for (const auto &row : ws.d_->cell_map_)
+        {
+            cells += row.second.size();
+        }
+
+        profiler_->current_part().cells += cells;
+    }
+
+    write_worksheet_footer(ws, worksheet_part, hyperlinks, cells_with_comments);
+}
+
+std::unordered_map<std::string, std::list<detached_zip_entry>> xlsx_producer::render_worksheets(
+    const std::vector<relationship> &workbook_rels)
+{
+    std::unordered_map<std::string, std::list<detached_zip_entry>> rendered;
+
+    if (streaming_) return rendered;
+
+    std::vector<relationship> worksheet_rels;
+
+    for (const auto &rel : workbook_rels)
+    {
+        if (rel.type() == relationship_type::worksheet)
+        {
+            worksheet_rels.push_back(rel);
+        }
+    }
+
+    auto thread_count = options_.worksheet_threads;
+
+    if (thread_count == 0)
+    {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    thread_count = std::min(thread_count, worksheet_rels.size());
+
+    if (thread_count < 2) return rendered;
+
+    // otherwise the open part would be profiled as if it took as long as the rendering
+    end_part();
+
+    // producers are made here because number_serialiser reads the locale when constructed
+    std::vector<std::unique_ptr<xlsx_producer>> renderers;
+    std::vector<std::list<detached_zip_entry>> parts(worksheet_rels.size());
+    std::vector<std::exception_ptr> errors(worksheet_rels.size());
+    // each renderer measures into its own profile, merged into this one afterwards
+    std::vector<serialization_profile> profiles(profiler_ ? worksheet_rels.size() : 0);
+
+    for (std::size_t i = 0; i < worksheet_rels.size(); ++i)
+    {
+        auto renderer_options = options_;
+        renderer_options.profile = profiler_ ? &profiles[i] : nullptr;
+        renderers.emplace_back(new xlsx_producer(source_, renderer_options));
+        renderers.back()->compacted_shared_strings_ = compacted_shared_strings_;
+    }
+
+    std::atomic<std::size_t> next_worksheet(0);
+
+    auto render = [&]() {
+        for (auto i = next_worksheet++; i < worksheet_rels.size(); i = next_worksheet++)
+        {
+            try
+            {
+                renderers[i]->render_worksheet(worksheet_rels[i], parts[i]);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    try
+    {
+        // this thread renders too
+        for (std::size_t i = 1; i < thread_count; ++i)
+        {
+            workers.emplace_back(render);
+        }
+    }
+    catch (...)
+    {
+        // carry on with however many threads could be started
+    }
+
+    render();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (std::size_t i = 0; i < worksheet_rels.size(); ++i)
+    {
+        if (errors[i])
+        {
+            std::rethrow_exception(errors[i]);
+        }
+
+        rendered[worksheet_rels[i].id()] = std::move(parts[i]);
+
+        if (profiler_)
+        {
+            profiler_->append(profiles[i]);
+        }
+    }
+
+    return rendered;
+}
+
+void xlsx_producer::render_worksheet(const relationship &rel, std::list<detached_zip_entry> &parts)
+{
+    detached_parts_ = &parts;
+
+    begin_part(rel.source().path().parent().append(rel.target().path()));
+    write_worksheet(rel);
+    end_part();
+
+    detached_parts_ = nullptr;
+}
+
+void xlsx_producer::write_worksheet_header(const worksheet &ws, const optional<range_reference> &dimension)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+    static const auto &xmlns_r = constants::ns("r");
+    static const auto &xmlns_mc = constants::ns("mc");
+    static const auto &xmlns_x14ac = constants::ns("x14ac");
+
     write_start_element(xmlns, "worksheet");
     write_namespace(xmlns, "");
     write_namespace(xmlns_r, "r");
 
-    auto using_namespace = [&ws](const std::string &ns) {
+    auto using_namespace = [this, &ws](const std::string &ns) {
         if (ns == "x14ac")
         {
-            if (ws.format_properties().dy_descent.is_set())
+            // rows are written with a literal x14ac prefix, so the prefix has to be declared
+            // whenever one might have dyDescent. Streamed rows aren't known in advance.
+            if (streaming_ || ws.format_properties().dy_descent.is_set())
             {
                 return true;
             }
 
-            auto highest = ws.highest_row();
-            for (auto row = ws.lowest_row(); row <= highest; ++row)
+            for (const auto &props : ws.d_->row_properties_)
             {
-                if (ws.has_row_properties(row) && ws.row_properties(row).dy_descent.is_set())
+                if (props.second.dy_descent.is_set())
                 {
                     return true;
                 }
@@ -2355,10 +2824,13 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         write_end_element(xmlns, "sheetPr");
     }
 
-    write_start_element(xmlns, "dimension");
-    const auto dimension = ws.calculate_dimension();
-    write_attribute("ref", dimension.is_single_cell() ? dimension.top_left().to_string() : dimension.to_string());
-    write_end_element(xmlns, "dimension");
+    if (dimension.is_set())
+    {
+        write_start_element(xmlns, "dimension");
+        const auto &ref = dimension.get();
+        write_attribute("ref", ref.is_single_cell() ? ref.top_left().to_string() : ref.to_string());
+        write_end_element(xmlns, "dimension");
+    }
 
     if (ws.has_view())
     {
@@ -2528,233 +3000,288 @@ void xlsx_producer::write_worksheet(const relationship &rel)
     {
         write_end_element(xmlns, "cols");
     }
+}
 
-    std::vector<std::pair<std::string, hyperlink>> hyperlinks;
-    std::vector<cell_reference> cells_with_comments;
+void xlsx_producer::begin_sheet_data()
+{
+    // an empty text node makes the serializer finish the start tag of the parent
+    // so that nothing it still has pending ends up after the rows
+    current_part_serializer_->characters("");
 
-    write_start_element(xmlns, "sheetData");
-    auto first_row = ws.lowest_row_or_props();
-    auto last_row = ws.highest_row_or_props();
-    auto first_block_column = constants::max_column();
-    auto last_block_column = constants::min_column();
+    sheet_data_writer_.reset(new buffered_xml_writer(*current_part_streambuf_));
+    sheet_data_empty_ = true;
+}
+
+void xlsx_producer::end_sheet_data()
+{
+    auto &out = *sheet_data_writer_;
 
-    for (auto row = first_row; row <= last_row; ++row)
+    if (sheet_data_empty_)
     {
-        bool any_non_null = false;
-        auto first_check_row = row;
-        auto last_check_row = row;
-        auto first_row_in_block = row == first_row || row % 16 == 1;
+        out.markup("<sheetData/>");
+    }
+    else
+    {
+        out.markup("</sheetData>");
+    }
 
-        // See note for CT_Row, span attribute about block optimization
-        if (first_row_in_block)
-        {
-            // reset block column range
-            first_block_column = constants::max_column();
-            last_block_column = constants::min_column();
+    out.flush();
+    sheet_data_writer_.reset();
+}
 
-            first_check_row = row;
-            // round up to the next multiple of 16
-            last_check_row = ((row / 16) + 1) * 16;
-        }
+void xlsx_producer::begin_row(const worksheet &ws, row_t row, column_t::index_t first_span,
+    column_t::index_t last_span, bool empty)
+{
+    auto &out = *sheet_data_writer_;
 
-        for (auto check_row = first_check_row; check_row <= last_check_row; ++check_row)
-        {
-            for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
-            {
-                auto ref = cell_reference(column, check_row);
-                auto cell = ws.d_->cell_map_.find(ref);
-                if (cell == ws.d_->cell_map_.end())
-                {
-                    continue;
-                }
-                if (cell->second.is_garbage_collectible())
-                {
-                    continue;
-                }
+    if (sheet_data_empty_)
+    {
+        out.markup("<sheetData>");
+        sheet_data_empty_ = false;
+    }
 
-                first_block_column = std::min(first_block_column, cell->second.column_);
-                last_block_column = std::max(last_block_column, cell->second.column_);
+    out.markup("<row r=\"");
+    out.integer(row);
+    out.markup("\"");
 
-                if (row == check_row)
-                {
-                    any_non_null = true;
-                }
-            }
+    if (first_span != 0)
+    {
+        out.markup(" spans=\"");
+        out.integer(first_span);
+        out.markup(":");
+        out.integer(last_span);
+        out.markup("\"");
+    }
+
+    if (ws.has_row_properties(row))
+    {
+        const auto &props = ws.row_properties(row);
+
+        if (props.style.is_set())
+        {
+            out.markup(" s=\"");
+            out.integer(props.style.get());
+            out.markup("\"");
         }
 
-        if (!any_non_null && !ws.has_row_properties(row)) continue;
+        if (props.custom_format.is_set())
+        {
+            out.markup(" customFormat=\"");
+            out.markup(write_bool(props.custom_format.get()));
+            out.markup("\"");
+        }
 
-        write_start_element(xmlns, "row");
-        write_attribute("r", row);
+        if (props.height.is_set())
+        {
+            out.markup(" ht=\"");
+            out.number(props.height.get());
+            out.markup("\"");
+        }
 
-        auto span_string = std::to_string(first_block_column.index) + ":"
-            + std::to_string(last_block_column.index);
-        write_attribute("spans", span_string);
+        if (props.hidden)
+        {
+            out.markup(" hidden=\"");
+            out.markup(write_bool(true));
+            out.markup("\"");
+        }
 
-        if (ws.has_row_properties(row))
+        if (props.custom_height)
         {
-            const auto &props = ws.row_properties(row);
+            out.markup(" customHeight=\"");
+            out.markup(write_bool(true));
+            out.markup("\"");
+        }
 
-            if (props.style.is_set())
-            {
-                write_attribute("s", props.style.get());
-            }
-            if (props.custom_format.is_set())
-            {
-                write_attribute("customFormat", write_bool(props.custom_format.get()));
-            }
+        // the worksheet header declares the x14ac prefix whenever a row has dyDescent
+        if (props.dy_descent.is_set())
+        {
+            out.markup(" x14ac:dyDescent=\"");
+            out.number(props.dy_descent.get());
+            out.markup("\"");
+        }
+    }
 
-            if (props.height.is_set())
-            {
-                auto height = props.height.get();
-                write_attribute("ht", converter_.serialise(height));
-            }
+    if (empty)
+    {
+        out.markup("/>");
+    }
+    else
+    {
+        out.markup(">");
+    }
+}
 
-            if (props.hidden)
-            {
-                write_attribute("hidden", write_bool(true));
-            }
+void xlsx_producer::end_row()
+{
+    sheet_data_writer_->markup("</row>");
+}
 
-            if (props.custom_height)
-            {
-                write_attribute("customHeight", write_bool(true));
-            }
+void xlsx_producer::write_cell(const cell &cell)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
 
-            if (props.dy_descent.is_set())
-            {
-                write_attribute<double>(xml::qname(xmlns_x14ac, "dyDescent"), props.dy_descent.get());
-            }
-        }
+    auto &out = *sheet_data_writer_;
+    const auto type = cell.data_type();
 
-        if (any_non_null)
-        {
-            for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
-            {
-                if (!ws.has_cell(cell_reference(column, row))) continue;
+    // begin cell attributes
 
-                auto cell = ws.cell(cell_reference(column, row));
+    char reference[max_cell_reference_length];
+    out.markup("<c r=\"");
+    out.markup(reference, encode_cell_reference(cell.d_->column_.index, cell.d_->row(), reference));
+    out.markup("\"");
 
-                if (cell.garbage_collectible()) continue;
+    if (cell.phonetics_visible())
+    {
+        out.markup(" ph=\"");
+        out.markup(write_bool(true));
+        out.markup("\"");
+    }
 
-                // record data about the cell needed later
+    if (cell.has_format())
+    {
+        out.markup(" s=\"");
+        out.integer(cell.format().d_->id);
+        out.markup("\"");
+    }
 
-                if (cell.has_comment())
-                {
-                    cells_with_comments.push_back(cell.reference());
-                }
+    switch (type)
+    {
+    case cell::type::empty:
+        break;
 
-                if (cell.has_hyperlink())
-                {
-                    hyperlinks.push_back(std::make_pair(cell.reference().to_string(), cell.hyperlink()));
-                }
+    case cell::type::boolean:
+        out.markup(" t=\"b\"");
+        break;
 
-                write_start_element(xmlns, "c");
+    case cell::type::date:
+        out.markup(" t=\"d\"");
+        break;
 
-                // begin cell attributes
+    case cell::type::error:
+        out.markup(" t=\"e\"");
+        break;
 
-                write_attribute("r", cell.reference().to_string());
+    case cell::type::inline_string:
+        out.markup(" t=\"inlineStr\"");
+        break;
 
-                if (cell.phonetics_visible())
-                {
-                    write_attribute("ph", write_bool(true));
-                }
+    case cell::type::number: // default, don't write it
+        break;
 
-                if (cell.has_format())
-                {
-                    write_attribute("s", cell.format().d_->id);
-                }
+    case cell::type::shared_string:
+        if (streaming_)
+        {
+            out.markup(" t=\"inlineStr\"");
+        }
+        else
+        {
+            out.markup(" t=\"s\"");
+        }
+        break;
 
-                switch (cell.data_type())
-                {
-                case cell::type::empty:
-                    break;
+    case cell::type::formula_string:
+        out.markup(" t=\"str\"");
+        break;
+    }
 
-                case cell::type::boolean:
-                    write_attribute("t", "b");
-                    break;
+    //write_attribute("cm", "");
+    //write_attribute("vm", "");
 
-                case cell::type::date:
-                    write_attribute("t", "d");
-                    break;
+    if (type == cell::type::empty && !cell.has_formula())
+    {
+        out.markup("/>");
+        return;
+    }
 
-                case cell::type::error:
-                    write_attribute("t", "e");
-                    break;
+    out.markup(">");
 
-                case cell::type::inline_string:
-                    write_attribute("t", "inlineStr");
-                    break;
+    // begin child elements
 
-                case cell::type::number: // default, don't write it
-                    //write_attribute("t", "n");
-                    break;
+    if (cell.has_formula())
+    {
+        out.markup("<f>");
+        out.text(cell.formula());
+        out.markup("</f>");
+    }
 
-                case cell::type::shared_string:
-                    write_attribute("t", "s");
-                    break;
+    switch (type)
+    {
+    case cell::type::empty:
+        break;
 
-                case cell::type::formula_string:
-                    write_attribute("t", "str");
-                    break;
-                }
+    case cell::type::boolean:
+        out.markup("<v>");
+        out.markup(write_bool(cell.value<bool>()));
+        out.markup("</v>");
+        break;
 
-                //write_attribute("cm", "");
-                //write_attribute("vm", "");
-                //write_attribute("ph", "");
+    case cell::type::date:
+    case cell::type::error:
+    case cell::type::formula_string:
+        out.markup("<v>");
+        out.text(cell.value<std::string>());
+        out.markup("</v>");
+        break;
 
-                // begin child elements
+    case cell::type::number:
+        out.markup("<v>");
+        out.number(cell.value<double>());
+        out.markup("</v>");
+        break;
 
-                if (cell.has_formula())
-                {
-                    write_element(xmlns, "f", cell.formula());
-                }
+    case cell::type::shared_string:
+        if (!streaming_)
+        {
+            out.markup("<v>");
+            out.integer(shared_string_id(static_cast<std::size_t>(cell.d_->value_numeric_)));
+            out.markup("</v>");
+            break;
+        }
+        // the shared string table isn't kept while streaming so the text is written inline
+        // fall through
 
-                switch (cell.data_type())
-                {
-                case cell::type::empty:
-                    break;
-
-                case cell::type::boolean:
-                    write_element(xmlns, "v", write_bool(cell.value<bool>()));
-                    break;
-
-                case cell::type::date:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-
-                case cell::type::error:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-
-                case cell::type::inline_string:
-                    write_start_element(xmlns, "is");
-                    write_rich_text(xmlns, cell.value<xyxlnt::rich_text>());
-                    write_end_element(xmlns, "is");
-                    break;
-
-                case cell::type::number:
-                    write_start_element(xmlns, "v");
-                    write_characters(converter_.serialise(cell.value<double>()));
-                    write_end_element(xmlns, "v");
-                    break;
-
-                case cell::type::shared_string:
-                    write_element(xmlns, "v", static_cast<std::size_t>(cell.d_->value_numeric_));
-                    break;
-
-                case cell::type::formula_string:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-                }
+    case cell::type::inline_string:
+    {
+        const auto text = cell.value<xyxlnt::rich_text>();
+        const auto &runs = text.runs();
 
-                write_end_element(xmlns, "c");
+        if (runs.size() == 1 && !runs.front().second.is_set())
+        {
+            if (runs.front().preserve_space)
+            {
+                out.markup("<is><t xml:space=\"preserve\">");
+            }
+            else
+            {
+                out.markup("<is><t>");
             }
-        }
 
-        write_end_element(xmlns, "row");
+            out.text(runs.front().first);
+            out.markup("</t></is>");
+        }
+        else
+        {
+            // formatted runs are rare enough to be left to the serializer
+            out.flush();
+            write_start_element(xmlns, "is");
+            write_rich_text(xmlns, text);
+            write_end_element(xmlns, "is");
+        }
+        break;
+    }
     }
 
-    write_end_element(xmlns, "sheetData");
+    out.markup("</c>");
+}
+
+void xlsx_producer::write_worksheet_footer(const worksheet &ws, const path &worksheet_part,
+    const std::vector<std::pair<std::string, hyperlink>> &hyperlinks,
+    const std::vector<cell_reference> &cells_with_comments)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+    static const auto &xmlns_r = constants::ns("r");
+
+    auto worksheet_rels = source_.manifest().relationships(worksheet_part);
 
     if (ws.has_auto_filter())
     {
@@ -3398,7 +3925,7 @@ void xlsx_producer::write_image(const path &image_path)
     end_part();
 
     vector_istreambuf buffer(source_.d_->images_.at(image_path.string()));
-    auto image_streambuf = archive_->open(image_path);
+    auto image_streambuf = open_archive_part(image_path);
     std::ostream(image_streambuf.get()) << &buffer;
 }
 
@@ -3407,7 +3934,7 @@ void xlsx_producer::write_binary(const path &binary_path)
     end_part();
 
     vector_istreambuf buffer(source_.d_->binaries_.at(binary_path.string()));
-    auto image_streambuf = archive_->open(binary_path);
+    auto image_streambuf = open_archive_part(binary_path);
     std::ostream(image_streambuf.get()) << &buffer;
 }
 
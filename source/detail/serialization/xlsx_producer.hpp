@@ -25,11 +25,18 @@
 
 #include <cstdint>
 #include <iostream>
+#include <list>
 #include <memory>
+#include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include <xyxlnt/cell/index_types.hpp>
 #include <xyxlnt/utils/numeric.hpp>
+#include <xyxlnt/utils/optional.hpp>
+#include <xyxlnt/workbook/save_options.hpp>
 #include <detail/constants.hpp>
 #include <detail/external/include_libstudxml.hpp>
 
@@ -45,7 +52,9 @@ class cell_reference;
 class color;
 class fill;
 class font;
+class hyperlink;
 class path;
+class range_reference;
 class relationship;
 class rich_text;
 class streaming_workbook_writer;
@@ -55,8 +64,12 @@ class worksheet;
 
 namespace detail {
 
+class buffered_xml_writer;
 class ozstream;
+class serialization_profiler;
+struct detached_zip_entry;
 struct cell_impl;
+struct row_key;
 struct worksheet_impl;
 
 /// <summary>
@@ -65,7 +78,7 @@ struct worksheet_impl;
 class xlsx_producer
 {
 public:
-	xlsx_producer(const workbook &target);
+	xlsx_producer(const workbook &target, const save_options &options = save_options());
 
     ~xlsx_producer();
 
@@ -76,11 +89,39 @@ public:
 private:
     friend class xyxlnt::streaming_workbook_writer;
 
+    /// <summary>
+    /// Starts a streamed write into destination. Worksheets are written as their cells
+    /// arrive and the remaining parts are written by populate_archive(true) at the end.
+    /// </summary>
     void open(std::ostream &destination);
 
+    /// <summary>
+    /// Makes ws the worksheet that add_cell writes to. Its part is begun lazily so
+    /// properties set before the first cell still end up ahead of sheetData.
+    /// </summary>
+    void begin_worksheet(worksheet ws);
+
+    /// <summary>
+    /// Writes the pending cell and the rest of the current worksheet's part.
+    /// </summary>
+    void end_worksheet();
+
+    /// <summary>
+    /// Writes the previously added cell, if any, and returns the reused streaming cell
+    /// positioned at ref. Throws invalid_parameter if ref doesn't follow that cell in
+    /// row-major order.
+    /// </summary>
     cell add_cell(const cell_reference &ref);
 
-    worksheet add_worksheet(const std::string &title);
+    /// <summary>
+    /// Serializes the pending streamed cell into the current worksheet part.
+    /// </summary>
+    void write_streaming_cell();
+
+    /// <summary>
+    /// Returns the path of ws's part in the archive.
+    /// </summary>
+    path worksheet_part(const worksheet &ws) const;
 
 	/// <summary>
 	/// Write all files needed to create a valid XLSX file which represents all
@@ -91,6 +132,12 @@ private:
     void begin_part(const path &part);
     void end_part();
 
+    /// <summary>
+    /// Returns a streambuf which compresses part into the archive, or into a new entry of
+    /// detached_parts_ if this producer is rendering a worksheet for another one.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open_archive_part(const path &part);
+
 	// Package Parts
 
 	void write_content_types();
@@ -123,6 +170,59 @@ private:
 	void write_dialogsheet(const relationship &rel);
 	void write_worksheet(const relationship &rel);
 
+    /// <summary>
+    /// Builds compacted_shared_strings_ from a single row-major pass over the cells of
+    /// every worksheet.
+    /// </summary>
+    void compact_shared_strings();
+
+    /// <summary>
+    /// Returns the index written for a cell holding the shared string at index.
+    /// </summary>
+    std::size_t shared_string_id(std::size_t index) const;
+
+    /// <summary>
+    /// Renders the worksheets among workbook_rels, and the parts that belong to them, on
+    /// options_.worksheet_threads threads. Returns the compressed parts keyed by relationship
+    /// id, or nothing if the worksheets should be written one after another instead.
+    /// </summary>
+    std::unordered_map<std::string, std::list<detached_zip_entry>> render_worksheets(
+        const std::vector<relationship> &workbook_rels);
+
+    /// <summary>
+    /// Writes the worksheet rel and its dependent parts into parts instead of an archive.
+    /// </summary>
+    void render_worksheet(const relationship &rel, std::list<detached_zip_entry> &parts);
+
+    // Worksheet pieces shared by write_worksheet and streaming
+
+    void write_worksheet_header(const worksheet &ws, const optional<range_reference> &dimension);
+
+    /// <summary>
+    /// Closes any start tag the serializer has pending and switches the current part to
+    /// sheet_data_writer_. Rows and cells are then written by begin_row, end_row and
+    /// write_cell until end_sheet_data.
+    /// </summary>
+    void begin_sheet_data();
+
+    /// <summary>
+    /// Closes sheetData and hands the current part back to the serializer.
+    /// </summary>
+    void end_sheet_data();
+
+    /// <summary>
+    /// Writes the start tag of row, leaving it open for cells unless empty is true.
+    /// The spans attribute is only written if first_span isn't 0.
+    /// </summary>
+    void begin_row(const worksheet &ws, row_t row, column_t::index_t first_span,
+        column_t::index_t last_span, bool empty);
+    void end_row();
+
+    void write_cell(const cell &cell);
+    void write_worksheet_footer(const worksheet &ws, const path &worksheet_part,
+        const std::vector<std::pair<std::string, hyperlink>> &hyperlinks,
+        const std::vector<cell_reference> &cells_with_comments);
+
 	// Sheet Relationship Target Parts
 
 	void write_comments(const relationship &rel, worksheet ws, const std::vector<cell_reference> &cells);
@@ -228,16 +328,88 @@ private:
 	/// </summary>
 	const workbook &source_;
 
+    save_options options_;
+
+    /// <summary>
+    /// Measures a save into options_.profile. Null when no profile was requested.
+    /// </summary>
+    std::unique_ptr<serialization_profiler> profiler_;
+
 	std::unique_ptr<ozstream> archive_;
+
+    /// <summary>
+    /// Where render_worksheet puts parts instead of archive_, otherwise null.
+    /// </summary>
+    std::list<detached_zip_entry> *detached_parts_ = nullptr;
+
+    /// <summary>
+    /// The shared string table written when options_.compact_shared_strings is set.
+    /// </summary>
+    struct compacted_shared_string_table
+    {
+        /// <summary>
+        /// The index written for each index into the workbook's shared strings.
+        /// </summary>
+        std::vector<std::size_t> ids;
+
+        /// <summary>
+        /// The workbook index of each string in the written table.
+        /// </summary>
+        std::vector<std::size_t> strings;
+
+        /// <summary>
+        /// The number of cells holding a shared string.
+        /// </summary>
+        std::size_t references = 0;
+    };
+
+    /// <summary>
+    /// Shared with the producers that render worksheets on other threads. Null unless
+    /// the shared strings are compacted.
+    /// </summary>
+    std::shared_ptr<const compacted_shared_string_table> compacted_shared_strings_;
     std::unique_ptr<xml::serializer> current_part_serializer_;
     std::unique_ptr<std::streambuf> current_part_streambuf_;
     std::ostream current_part_stream_;
 
+    /// <summary>
+    /// Writes the rows and cells of the current sheetData, bypassing current_part_serializer_.
+    /// Null outside of begin_sheet_data and end_sheet_data.
+    /// </summary>
+    std::unique_ptr<buffered_xml_writer> sheet_data_writer_;
+
+    /// <summary>
+    /// True until the first row of the current sheetData is written so that an empty
+    /// sheetData can be closed as <sheetData/> like the serializer would.
+    /// </summary>
+    bool sheet_data_empty_ = false;
+
     bool streaming_ = false;
 
+    /// <summary>
+    /// The single cell handed out by add_cell, written and reset when the next one is added.
+    /// </summary>
     std::unique_ptr<detail::cell_impl> streaming_cell_;
 
-    detail::cell_impl *current_cell_;
+    /// <summary>
+    /// The row of streaming_cell_, which isn't stored in a worksheet row.
+    /// </summary>
+    std::unique_ptr<detail::row_key> streaming_cell_row_;
+
+    /// <summary>
+    /// True if streaming_cell_ has been handed out but not yet written.
+    /// </summary>
+    bool streaming_cell_pending_ = false;
+
+    /// <summary>
+    /// True once the current worksheet's part has been begun and sheetData opened.
+    /// </summary>
+    bool streaming_sheet_data_open_ = false;
+
+    /// <summary>
+    /// The row element open in the streamed sheetData, or 0 if none is.
+    /// </summary>
+    row_t streaming_row_ = 0;
 
     detail::worksheet_impl *current_worksheet_;
     detail::number_serialiser converter_;
@@ -486,6 +486,66 @@ std::unique_ptr<std::streambuf> ozstream::open(const path &filename)
     return std::unique_ptr<zip_streambuf_compress>(buffer);
 }
 
+namespace {
+
+// Owns the stream that zip_streambuf_compress writes to. This is a base class so
+// that it's constructed before and destroyed after the compressing streambuf.
+struct detached_zip_destination
+{
+    explicit detached_zip_destination(std::vector<std::uint8_t> &data)
+        : buffer(data),
+          stream(&buffer)
+    {
+    }
+
+    vector_ostreambuf buffer;
+    std::ostream stream;
+};
+
+class detached_zip_streambuf : private detached_zip_destination, public zip_streambuf_compress
+{
+public:
+    explicit detached_zip_streambuf(detached_zip_entry &entry)
+        : detached_zip_destination(entry.data),
+          zip_streambuf_compress(&entry.header, detached_zip_destination::stream)
+    {
+    }
+};
+
+} // namespace
+
+std::unique_ptr<std::streambuf> ozstream::open_detached(const path &filename, detached_zip_entry &entry)
+{
+    entry.header = zheader();
+    entry.header.filename = filename.string();
+    entry.data.clear();
+
+    return std::unique_ptr<std::streambuf>(new detached_zip_streambuf(entry));
+}
+
+void ozstream::add(const detached_zip_entry &entry)
+{
+    file_headers_.push_back(entry.header);
+    file_headers_.back().header_offset = static_cast<std::uint32_t>(destination_stream_.tellp());
+
+    destination_stream_.write(reinterpret_cast<const char *>(entry.data.data()),
+        static_cast<std::streamsize>(entry.data.size()));
+}
+
+const zheader &ozstream::header(const path &filename) const
+{
+    const auto name = filename.string();
+    auto match = std::find_if(file_headers_.rbegin(), file_headers_.rend(),
+        [&name](const zheader &header) { return header.filename == name; });
+
+    if (match == file_headers_.rend())
+    {
+        throw xyxlnt::key_not_found();
+    }
+
+    return *match;
+}
+
 izstream::izstream(std::istream &stream)
     : source_stream_(stream)
 {
@@ -627,5 +687,10 @@ bool izstream::has_file(const path &filename) const
     return file_headers_.count(filename.string()) != 0;
 }
 
+const zheader &izstream::header(const path &filename) const
+{
+    return file_headers_.at(filename.string());
+}
+
 } // namespace detail
 } // namespace xyxlnt
@@ -68,6 +68,20 @@ struct XYXLNT_API zheader
     std::uint32_t header_offset = 0;
 };
 
+/// <summary>
+/// A file compressed into memory by ozstream::open_detached which can be added to an
+/// archive later with ozstream::add. This lets files be compressed on other threads.
+/// </summary>
+struct XYXLNT_API detached_zip_entry
+{
+    zheader header;
+
+    /// <summary>
+    /// The local file header followed by the compressed data.
+    /// </summary>
+    std::vector<std::uint8_t> data;
+};
+
 /// <summary>
 /// Writes a series of uncompressed binary file data as ostreams into another ostream
 /// according to the ZIP format.
@@ -90,6 +104,23 @@ public:
     /// </summary>
     std::unique_ptr<std::streambuf> open(const path &file);
 
+    /// <summary>
+    /// Returns a pointer to a streambuf which compresses the data it receives into entry
+    /// instead of this archive. entry is complete once the streambuf has been destroyed.
+    /// </summary>
+    static std::unique_ptr<std::streambuf> open_detached(const path &file, detached_zip_entry &entry);
+
+    /// <summary>
+    /// Appends a file previously compressed by open_detached to the archive.
+    /// </summary>
+    void add(const detached_zip_entry &entry);
+
+    /// <summary>
+    /// Returns the header of the file most recently written with the given name. The sizes
+    /// are only known once the streambuf writing it has been destroyed.
+    /// </summary>
+    const zheader &header(const path &file) const;
+
 private:
     std::vector<zheader> file_headers_;
     std::ostream &destination_stream_;
@@ -132,6 +163,11 @@ public:
     /// </summary>
     bool has_file(const path &filename) const;
 
+    /// <summary>
+    /// Returns the header of the given file.
+    /// </summary>
+    const zheader &header(const path &file) const;
+
 private:
     /// <summary>
     ///
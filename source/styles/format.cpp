@@ -38,7 +38,7 @@ format::format(detail::format_impl *d)
 
 void format::clear_style()
 {
-    d_->style.clear();
+    d_->parent->modify_format(d_, [](detail::format_impl &impl) { impl.style.clear(); });
 }
 
 format format::style(const xyxlnt::style &new_style)
@@ -49,7 +49,7 @@ format format::style(const xyxlnt::style &new_style)
 
 format format::style(const std::string &new_style)
 {
-    d_->style = new_style;
+    d_->parent->modify_format(d_, [&new_style](detail::format_impl &impl) { impl.style = new_style; });
     return format(d_);
 }
 
@@ -154,8 +154,10 @@ format format::number_format(const xyxlnt::number_format &new_number_format, opt
 
     if (!copy.has_id())
     {
+        // a format string that is already in the stylesheet keeps its id
+        auto &number_formats = d_->parent->number_formats;
         copy.id(d_->parent->next_custom_number_format_id());
-        d_->parent->number_formats.push_back(copy);
+        copy = number_formats[d_->parent->find_or_add(number_formats, copy)];
     }
 
     d_ = d_->parent->find_or_create_with(d_, copy, applied);
@@ -222,7 +224,7 @@ bool format::pivot_button() const
 
 void format::pivot_button(bool show)
 {
-    d_->pivot_button_ = show;
+    d_->parent->modify_format(d_, [show](detail::format_impl &impl) { impl.pivot_button_ = show; });
 }
 
 bool format::quote_prefix() const
@@ -232,7 +234,7 @@ bool format::quote_prefix() const
 
 void format::quote_prefix(bool quote)
 {
-    d_->quote_prefix_ = quote;
+    d_->parent->modify_format(d_, [quote](detail::format_impl &impl) { impl.quote_prefix_ = quote; });
 }
 
 } // namespace xyxlnt
@@ -240,7 +240,8 @@ number_format::number_format(std::size_t id)
 }
 
 number_format::number_format(const std::string &format_string)
-    : format_string_(format_string)
+    : format_string_(format_string),
+      cache_(std::make_shared<detail::number_format_cache>())
 {
 }
 
@@ -272,6 +273,7 @@ std::string number_format::format_string() const
 void number_format::format_string(const std::string &format_string)
 {
     format_string_ = format_string;
+    cache_ = std::make_shared<detail::number_format_cache>();
     id_ = 0;
 
     for (const auto &pair : builtin_formats())
@@ -287,6 +289,7 @@ void number_format::format_string(const std::string &format_string)
 void number_format::format_string(const std::string &format_string, std::size_t id)
 {
     format_string_ = format_string;
+    cache_ = std::make_shared<detail::number_format_cache>();
     id_ = id;
 }
 
@@ -312,37 +315,17 @@ std::size_t number_format::id() const
 
 bool number_format::is_date_format() const
 {
-    detail::number_format_parser p(format_string_);
-    p.parse();
-    auto parsed = p.result();
-
-    bool any_datetime = false;
-    bool any_timedelta = false;
-
-    for (const auto &section : parsed)
-    {
-        if (section.is_datetime)
-        {
-            any_datetime = true;
-        }
-
-        if (section.is_timedelta)
-        {
-            any_timedelta = true;
-        }
-    }
-
-    return any_datetime && !any_timedelta;
+    return cache_->get(format_string_).is_date_format;
 }
 
 std::string number_format::format(const std::string &text) const
 {
-    return detail::number_formatter(format_string_, calendar::windows_1900).format_text(text);
+    return detail::number_formatter(cache_->get(format_string_).codes, calendar::windows_1900).format_text(text);
 }
 
 std::string number_format::format(double number, calendar base_date) const
 {
-    return detail::number_formatter(format_string_, base_date).format_number(number);
+    return detail::number_formatter(cache_->get(format_string_).codes, base_date).format_number(number);
 }
 
 bool number_format::operator==(const number_format &other) const
@@ -26,6 +26,7 @@
 #include <xyxlnt/utils/date.hpp>
 #include <xyxlnt/utils/datetime.hpp>
 #include <xyxlnt/utils/time.hpp>
+#include <detail/serial_date.hpp>
 
 namespace {
 
@@ -45,11 +46,20 @@ namespace xyxlnt {
 
 datetime datetime::from_number(double raw_time, calendar base_date)
 {
-    auto date_part = date::from_number(static_cast<int>(raw_time), base_date);
-    auto time_part = time::from_number(raw_time);
+    datetime result(0, 0, 0);
+    from_numbers(&raw_time, 1, base_date, &result);
 
-    return datetime(date_part.year, date_part.month, date_part.day, time_part.hour, time_part.minute, time_part.second,
-        time_part.microsecond);
+    return result;
+}
+
+void datetime::from_numbers(const double *numbers, std::size_t count, calendar base_date, datetime *result)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto &dt = result[i];
+        detail::date_from_serial(static_cast<int>(numbers[i]), base_date, dt.year, dt.month, dt.day);
+        detail::time_from_serial(numbers[i], dt.hour, dt.minute, dt.second, dt.microsecond);
+    }
 }
 
 bool datetime::operator==(const datetime &comparand) const
@@ -65,8 +75,20 @@ bool datetime::operator==(const datetime &comparand) const
 
 double datetime::to_number(calendar base_date) const
 {
-    return date(year, month, day).to_number(base_date)
-        + time(hour, minute, second, microsecond).to_number();
+    double result;
+    to_numbers(this, 1, base_date, &result);
+
+    return result;
+}
+
+void datetime::to_numbers(const datetime *datetimes, std::size_t count, calendar base_date, double *result)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto &dt = datetimes[i];
+        result[i] = detail::serial_from_date(dt.year, dt.month, dt.day, base_date)
+            + detail::serial_from_time(dt.hour, dt.minute, dt.second, dt.microsecond);
+    }
 }
 
 std::string datetime::to_string() const
@@ -24,6 +24,7 @@
 #include <ctime>
 
 #include <xyxlnt/utils/time.hpp>
+#include <detail/serial_date.hpp>
 
 namespace {
 
@@ -46,37 +47,7 @@ namespace xyxlnt {
 time time::from_number(double raw_time)
 {
     time result;
-
-    double integer_part;
-    double fractional_part = std::modf(static_cast<double>(raw_time), &integer_part);
-
-    fractional_part *= 24;
-    result.hour = static_cast<int>(fractional_part);
-    fractional_part = 60 * (fractional_part - result.hour);
-    result.minute = static_cast<int>(fractional_part);
-    fractional_part = 60 * (fractional_part - result.minute);
-    result.second = static_cast<int>(fractional_part);
-    fractional_part = 1000000 * (fractional_part - result.second);
-    result.microsecond = static_cast<int>(fractional_part);
-
-    if (result.microsecond == 999999 && fractional_part - result.microsecond > 0.5)
-    {
-        result.microsecond = 0;
-        result.second += 1;
-
-        if (result.second == 60)
-        {
-            result.second = 0;
-            result.minute += 1;
-
-            // TODO: too much nesting
-            if (result.minute == 60)
-            {
-                result.minute = 0;
-                result.hour += 1;
-            }
-        }
-    }
+    detail::time_from_serial(raw_time, result.hour, result.minute, result.second, result.microsecond);
 
     return result;
 }
@@ -112,15 +83,7 @@ time::time(const std::string &time_string)
 
 double time::to_number() const
 {
-    std::uint64_t microseconds = static_cast<std::uint64_t>(microsecond);
-    microseconds += static_cast<std::uint64_t>(second * 1e6);
-    microseconds += static_cast<std::uint64_t>(minute * 1e6 * 60);
-    auto microseconds_per_hour = static_cast<std::uint64_t>(1e6) * 60 * 60;
-    microseconds += static_cast<std::uint64_t>(hour) * microseconds_per_hour;
-    auto number = static_cast<double>(microseconds) / (24.0 * static_cast<double>(microseconds_per_hour));
-    number = std::floor(number * 100e9 + 0.5) / 100e9;
-
-    return number;
+    return detail::serial_from_time(hour, minute, second, microsecond);
 }
 
 time time::now()
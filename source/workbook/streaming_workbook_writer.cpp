@@ -50,19 +50,47 @@ void streaming_workbook_writer::close()
 {
     if (producer_)
     {
+        if (producer_->current_worksheet_ == nullptr)
+        {
+            // nothing was added but the workbook still needs its sheet
+            producer_->begin_worksheet(workbook_->sheet_by_index(0));
+        }
+
+        producer_->end_worksheet();
+        producer_->populate_archive(true);
+
         producer_.reset(nullptr);
+        stream_.reset(nullptr);
         stream_buffer_.reset(nullptr);
     }
 }
 
 cell streaming_workbook_writer::add_cell(const cell_reference &ref)
 {
+    if (producer_->current_worksheet_ == nullptr)
+    {
+        // cells added before any worksheet go to the sheet every new workbook starts with
+        producer_->begin_worksheet(workbook_->sheet_by_index(0));
+    }
+
     return producer_->add_cell(ref);
 }
 
 worksheet streaming_workbook_writer::add_worksheet(const std::string &title)
 {
-    return producer_->add_worksheet(title);
+    auto ws = workbook_->sheet_by_index(0);
+
+    // the first sheet is reused unless cells were already added to it
+    if (producer_->current_worksheet_ != nullptr)
+    {
+        producer_->end_worksheet();
+        ws = workbook_->create_sheet();
+    }
+
+    ws.title(title);
+    producer_->begin_worksheet(ws);
+
+    return ws;
 }
 
 void streaming_workbook_writer::open(std::vector<std::uint8_t> &data)
@@ -100,9 +128,6 @@ void streaming_workbook_writer::open(std::ostream &stream)
     workbook_.reset(new workbook());
     producer_.reset(new detail::xlsx_producer(*workbook_));
     producer_->open(stream);
-    producer_->current_worksheet_ = new detail::worksheet_impl(workbook_.get(), 1, "Sheet1");
-    producer_->current_cell_ = new detail::cell_impl();
-    producer_->current_cell_->parent_ = producer_->current_worksheet_;
 }
 
 } // namespace xyxlnt
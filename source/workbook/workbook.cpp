@@ -26,6 +26,7 @@
 #include <array>
 #include <fstream>
 #include <functional>
+#include <iterator>
 #include <set>
 #ifdef _MSC_VER
 #define _SILENCE_CXX23_ALIGNED_STORAGE_DEPRECATION_WARNING
@@ -45,8 +46,11 @@
 #include <xyxlnt/utils/exceptions.hpp>
 #include <xyxlnt/utils/path.hpp>
 #include <xyxlnt/utils/variant.hpp>
+#include <xyxlnt/workbook/load_options.hpp>
+#include <xyxlnt/workbook/memory_usage.hpp>
 #include <xyxlnt/workbook/metadata_property.hpp>
 #include <xyxlnt/workbook/named_range.hpp>
+#include <xyxlnt/workbook/save_options.hpp>
 #include <xyxlnt/workbook/theme.hpp>
 #include <xyxlnt/workbook/workbook.hpp>
 #include <xyxlnt/workbook/workbook_view.hpp>
@@ -57,6 +61,7 @@
 #include <detail/constants.hpp>
 #include <detail/default_case.hpp>
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/memory_meter.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <detail/serialization/excel_thumbnail.hpp>
@@ -260,6 +265,16 @@ std::string content_type(xyxlnt::relationship_type type)
     default_case("application/xml");
 }
 
+// Formats are garbage collected in batches, so unreferenced formats may still be
+// waiting to be removed. Collect them before saving so they aren't written out.
+void collect_pending_styles(xyxlnt::detail::workbook_impl &impl)
+{
+    if (impl.stylesheet_.is_set() && impl.stylesheet_.get().unreferenced_formats > 0)
+    {
+        impl.stylesheet_.get().garbage_collect();
+    }
+}
+
 } // namespace
 
 namespace xyxlnt {
@@ -821,6 +836,20 @@ worksheet workbook::copy_sheet(worksheet to_copy)
     impl.id_ = new_sheet.id();
     *new_sheet.d_ = impl;
 
+    // the copied cells refer to the same shared strings and cells
+    for (auto &row : new_sheet.d_->cell_map_)
+    {
+        for (auto &cell : row.second)
+        {
+            if (cell.second.type_ == cell_type::shared_string)
+            {
+                d_->reference_shared_string(static_cast<std::size_t>(cell.second.value_numeric_));
+            }
+
+            d_->update_reference_cell(&cell.second);
+        }
+    }
+
     return new_sheet;
 }
 
@@ -836,8 +865,8 @@ worksheet workbook::copy_sheet(worksheet to_copy, std::size_t index)
         {
         }
 
-        d_->worksheets_.insert(iter, d_->worksheets_.back());
-        d_->worksheets_.pop_back();
+        // relinked rather than copied so that the sheet and its cells keep their addresses
+        d_->worksheets_.splice(iter, d_->worksheets_, std::prev(d_->worksheets_.end()));
     }
 
     return sheet_by_index(index);
@@ -893,9 +922,14 @@ range workbook::named_range(const std::string &name)
 }
 
 void workbook::load(std::istream &stream)
+{
+    load(stream, load_options());
+}
+
+void workbook::load(std::istream &stream, const load_options &options)
 {
     clear();
-    detail::xlsx_consumer consumer(*this);
+    detail::xlsx_consumer consumer(*this, options);
 
     try
     {
@@ -927,11 +961,28 @@ void workbook::load(const std::vector<std::uint8_t> &data)
     load(data_stream);
 }
 
+void workbook::load(const std::vector<std::uint8_t> &data, const load_options &options)
+{
+    if (data.size() < 22) // the shortest ZIP file is 22 bytes
+    {
+        throw xyxlnt::exception("file is empty or malformed");
+    }
+
+    xyxlnt::detail::vector_istreambuf data_buffer(data);
+    std::istream data_stream(&data_buffer);
+    load(data_stream, options);
+}
+
 void workbook::load(const std::string &filename)
 {
     return load(path(filename));
 }
 
+void workbook::load(const std::string &filename, const load_options &options)
+{
+    return load(path(filename), options);
+}
+
 void workbook::load(const path &filename)
 {
     std::ifstream file_stream;
@@ -945,6 +996,19 @@ void workbook::load(const path &filename)
     load(file_stream);
 }
 
+void workbook::load(const path &filename, const load_options &options)
+{
+    std::ifstream file_stream;
+    open_stream(file_stream, filename.string());
+
+    if (!file_stream.good())
+    {
+        throw xyxlnt::exception("file not found " + filename.string());
+    }
+
+    load(file_stream, options);
+}
+
 void workbook::load(const std::string &filename, const std::string &password)
 {
     return load(path(filename), password);
@@ -996,6 +1060,13 @@ void workbook::save(std::vector<std::uint8_t> &data, const std::string &password
     save(data_stream, password);
 }
 
+void workbook::save(std::vector<std::uint8_t> &data, const save_options &options) const
+{
+    xyxlnt::detail::vector_ostreambuf data_buffer(data);
+    std::ostream data_stream(&data_buffer);
+    save(data_stream, options);
+}
+
 void workbook::save(const std::string &filename) const
 {
     save(path(filename));
@@ -1006,6 +1077,11 @@ void workbook::save(const std::string &filename, const std::string &password) co
     save(path(filename), password);
 }
 
+void workbook::save(const std::string &filename, const save_options &options) const
+{
+    save(path(filename), options);
+}
+
 void workbook::save(const path &filename) const
 {
     std::ofstream file_stream;
@@ -1020,14 +1096,28 @@ void workbook::save(const path &filename, const std::string &password) const
     save(file_stream, password);
 }
 
+void workbook::save(const path &filename, const save_options &options) const
+{
+    std::ofstream file_stream;
+    open_stream(file_stream, filename.string());
+    save(file_stream, options);
+}
+
 void workbook::save(std::ostream &stream) const
 {
-    detail::xlsx_producer producer(*this);
+    save(stream, save_options());
+}
+
+void workbook::save(std::ostream &stream, const save_options &options) const
+{
+    collect_pending_styles(*d_);
+    detail::xlsx_producer producer(*this, options);
     producer.write(stream);
 }
 
 void workbook::save(std::ostream &stream, const std::string &password) const
 {
+    collect_pending_styles(*d_);
     detail::xlsx_producer producer(*this);
     producer.write(stream, password);
 }
@@ -1047,6 +1137,13 @@ void workbook::save(const std::wstring &filename, const std::string &password) c
     save(file_stream, password);
 }
 
+void workbook::save(const std::wstring &filename, const save_options &options) const
+{
+    std::ofstream file_stream;
+    open_stream(file_stream, filename);
+    save(file_stream, options);
+}
+
 void workbook::load(const std::wstring &filename)
 {
     std::ifstream file_stream;
@@ -1060,6 +1157,13 @@ void workbook::load(const std::wstring &filename, const std::string &password)
     open_stream(file_stream, filename);
     load(file_stream, password);
 }
+
+void workbook::load(const std::wstring &filename, const load_options &options)
+{
+    std::ifstream file_stream;
+    open_stream(file_stream, filename);
+    load(file_stream, options);
+}
 #endif
 
 void workbook::remove_sheet(worksheet ws)
@@ -1079,6 +1183,15 @@ void workbook::remove_sheet(worksheet ws)
     d_->manifest_.unregister_override_type(ws_part);
     auto rel_id_map = d_->manifest_.unregister_relationship(wb_rel.target(), ws_rel_id);
     d_->sheet_title_rel_id_map_.erase(ws.title());
+
+    for (auto &row : match_iter->cell_map_)
+    {
+        for (auto &cell : row.second)
+        {
+            cell.second.detach();
+        }
+    }
+
     d_->worksheets_.erase(match_iter);
 
     // Shift sheet title->ID mappings down as a result of manifest::unregister_relationship above.
@@ -1104,8 +1217,8 @@ worksheet workbook::create_sheet(std::size_t index)
         {
         }
 
-        d_->worksheets_.insert(iter, d_->worksheets_.back());
-        d_->worksheets_.pop_back();
+        // relinked rather than copied so that the sheet and its cells keep their addresses
+        d_->worksheets_.splice(iter, d_->worksheets_, std::prev(d_->worksheets_.end()));
     }
 
     return sheet_by_index(index);
@@ -1404,21 +1517,40 @@ std::size_t workbook::add_shared_string(const rich_text &shared, bool allow_dupl
 {
     register_workbook_part(relationship_type::shared_string_table);
 
+    auto &values = d_->shared_strings_values_;
+
     if (!allow_duplicates)
     {
-        auto it = d_->shared_strings_ids_.find(shared);
+        d_->shared_strings_index_.sync(values);
+        auto id = d_->shared_strings_index_.find(values, shared);
 
-        if (it != d_->shared_strings_ids_.end())
+        if (id != detail::shared_string_index::npos)
         {
-            return it->second;
+            return id;
         }
     }
 
-    auto sz = d_->shared_strings_ids_.size();
-    d_->shared_strings_ids_[shared] = sz;
-    d_->shared_strings_values_.push_back(shared);
+    values.push_back(shared);
+
+    return values.size() - 1;
+}
+
+std::size_t workbook::add_shared_string(const std::string &shared)
+{
+    register_workbook_part(relationship_type::shared_string_table);
+
+    auto &values = d_->shared_strings_values_;
+    d_->shared_strings_index_.sync(values);
+    auto id = d_->shared_strings_index_.find(values, shared);
+
+    if (id != detail::shared_string_index::npos)
+    {
+        return id;
+    }
+
+    values.push_back(rich_text(shared));
 
-    return sz;
+    return values.size() - 1;
 }
 
 bool workbook::contains(const std::string &sheet_title) const
@@ -1591,6 +1723,11 @@ void workbook::calculation_properties(const class calculation_properties &props)
     d_->calculation_properties_ = props;
 }
 
+memory_usage workbook::memory_usage() const
+{
+    return detail::memory_meter::measure(*d_);
+}
+
 void workbook::garbage_collect_formulae()
 {
     auto any_with_formula = false;
@@ -21,6 +21,8 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <unordered_map>
+
 #include <xyxlnt/cell/cell.hpp>
 #include <xyxlnt/styles/style.hpp>
 #include <xyxlnt/workbook/workbook.hpp>
@@ -28,6 +30,37 @@
 #include <xyxlnt/worksheet/range_iterator.hpp>
 #include <xyxlnt/worksheet/range_reference.hpp>
 #include <xyxlnt/worksheet/worksheet.hpp>
+#include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/format_impl.hpp>
+#include <detail/implementations/stylesheet.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
+
+namespace {
+
+// Adds a custom number format to the stylesheet and returns it as stored. A format without an
+// id is given the next custom one unless its format string is already there, as in
+// format::number_format.
+xyxlnt::number_format store_number_format(xyxlnt::detail::stylesheet &stylesheet,
+    const xyxlnt::number_format &new_number_format)
+{
+    auto copy = new_number_format;
+    auto &number_formats = stylesheet.number_formats;
+
+    if (!copy.has_id())
+    {
+        copy.id(stylesheet.next_custom_number_format_id());
+        return number_formats[stylesheet.find_or_add(number_formats, copy)];
+    }
+
+    if (copy.id() >= 164)
+    {
+        stylesheet.find_or_add(number_formats, copy);
+    }
+
+    return copy;
+}
+
+} // namespace
 
 namespace xyxlnt {
 
@@ -139,43 +172,128 @@ bool range::contains(const cell_reference &cell_ref)
 
 range range::alignment(const xyxlnt::alignment &new_alignment)
 {
-    apply([&new_alignment](class cell c) { c.alignment(new_alignment); });
+    restyle([&new_alignment](detail::format_impl &impl) {
+        impl.alignment_id = impl.parent->find_or_add(impl.parent->alignments, new_alignment);
+        impl.alignment_applied = true;
+    });
     return *this;
 }
 
 range range::border(const xyxlnt::border &new_border)
 {
-    apply([&new_border](class cell c) { c.border(new_border); });
+    restyle([&new_border](detail::format_impl &impl) {
+        impl.border_id = impl.parent->find_or_add(impl.parent->borders, new_border);
+        impl.border_applied = true;
+    });
     return *this;
 }
 
 range range::fill(const xyxlnt::fill &new_fill)
 {
-    apply([&new_fill](class cell c) { c.fill(new_fill); });
+    restyle([&new_fill](detail::format_impl &impl) {
+        impl.fill_id = impl.parent->find_or_add(impl.parent->fills, new_fill);
+        impl.fill_applied = true;
+    });
     return *this;
 }
 
 range range::font(const xyxlnt::font &new_font)
 {
-    apply([&new_font](class cell c) { c.font(new_font); });
+    restyle([&new_font](detail::format_impl &impl) {
+        impl.font_id = impl.parent->find_or_add(impl.parent->fonts, new_font);
+        impl.font_applied = true;
+    });
     return *this;
 }
 
 range range::number_format(const xyxlnt::number_format &new_number_format)
 {
-    apply([&new_number_format](class cell c) { c.number_format(new_number_format); });
+    optional<std::size_t> id;
+
+    restyle([&new_number_format, &id](detail::format_impl &impl) {
+        if (!id.is_set())
+        {
+            id = store_number_format(*impl.parent, new_number_format).id();
+        }
+        impl.number_format_id = id.get();
+        impl.number_format_applied = true;
+    });
     return *this;
 }
 
 range range::protection(const xyxlnt::protection &new_protection)
 {
-    apply([&new_protection](class cell c) { c.protection(new_protection); });
+    restyle([&new_protection](detail::format_impl &impl) {
+        impl.protection_id = impl.parent->find_or_add(impl.parent->protections, new_protection);
+        impl.protection_applied = true;
+    });
+    return *this;
+}
+
+range range::apply_format(const xyxlnt::format &new_format)
+{
+    auto target = new_format.d_;
+    std::size_t assigned = 0;
+
+    auto assign = [target, &assigned](detail::cell_impl &cell, std::size_t, std::size_t) {
+        if (cell.format_.is_set())
+        {
+            if (cell.format_.get() == target) return;
+            cell.format_.get()->parent->release_format(*cell.format_.get());
+        }
+
+        cell.format_ = target;
+        ++assigned;
+    };
+
+    const auto top_left = ref_.top_left();
+    const auto bottom_right = ref_.bottom_right();
+
+    if (skip_null_)
+    {
+        ws_.d_->visit_block(top_left.column(), top_left.row(), bottom_right.column(), bottom_right.row(), assign);
+    }
+    else
+    {
+        ws_.d_->fill_block(top_left.column(), top_left.row(), ref_.height(), ref_.width(), assign);
+    }
+
+    if (assigned > 0)
+    {
+        target->references += assigned;
+        target->parent->collect_garbage_if_needed();
+    }
+
     return *this;
 }
 
 range range::style(const class style &new_style)
 {
-    apply([&new_style](class cell c) { c.style(new_style); });
+    const auto new_border = new_style.border();
+    const auto new_fill = new_style.fill();
+    const auto new_font = new_style.font();
+    const auto new_number_format = new_style.number_format();
+    const auto style_name = new_style.name();
+    optional<std::size_t> number_format_id;
+
+    // the same components cell::style sets, without marking them as applied
+    restyle([&](detail::format_impl &impl) {
+        auto &stylesheet = *impl.parent;
+        impl.border_id = stylesheet.find_or_add(stylesheet.borders, new_border);
+        impl.border_applied.clear();
+        impl.fill_id = stylesheet.find_or_add(stylesheet.fills, new_fill);
+        impl.fill_applied.clear();
+        impl.font_id = stylesheet.find_or_add(stylesheet.fonts, new_font);
+        impl.font_applied.clear();
+        if (!number_format_id.is_set())
+        {
+            number_format_id = store_number_format(stylesheet, new_number_format).id();
+        }
+        impl.number_format_id = number_format_id.get();
+        impl.number_format_applied.clear();
+        impl.style = style_name;
+    });
+
     return *this;
 }
 
@@ -200,6 +318,69 @@ void range::apply(std::function<void(class cell)> f)
     }
 }
 
+void range::restyle(const std::function<void(detail::format_impl &)> &modify)
+{
+    // each distinct source format is resolved once; cells then only swap pointers
+    std::unordered_map<detail::format_impl *, detail::format_impl *> targets;
+    detail::format_impl *blank = nullptr;
+    detail::stylesheet *stylesheet = nullptr;
+
+    auto restyle_cell = [&](detail::cell_impl &cell, std::size_t, std::size_t) {
+        auto source = cell.format_.is_set() ? cell.format_.get() : nullptr;
+
+        if (source == nullptr)
+        {
+            if (blank == nullptr)
+            {
+                blank = ws_.workbook().create_format().d_;
+            }
+
+            source = blank;
+        }
+
+        auto target = targets.find(source);
+
+        if (target == targets.end())
+        {
+            auto pattern = *source;
+            modify(pattern);
+            stylesheet = source->parent;
+            target = targets.emplace(source, stylesheet->find_or_add_format(pattern)).first;
+        }
+
+        if (target->second == source) return;
+
+        if (source != blank)
+        {
+            stylesheet->release_format(*source);
+        }
+
+        ++target->second->references;
+        cell.format_ = target->second;
+    };
+
+    const auto top_left = ref_.top_left();
+    const auto bottom_right = ref_.bottom_right();
+
+    if (skip_null_)
+    {
+        ws_.d_->visit_block(top_left.column(), top_left.row(), bottom_right.column(), bottom_right.row(), restyle_cell);
+    }
+    else
+    {
+        ws_.d_->fill_block(top_left.column(), top_left.row(), ref_.height(), ref_.width(), restyle_cell);
+    }
+
+    if (stylesheet == nullptr) return;
+
+    if (blank != nullptr && blank->references == 0)
+    {
+        ++stylesheet->unreferenced_formats;
+    }
+
+    stylesheet->collect_garbage_if_needed();
+}
+
 cell range::cell(const cell_reference &ref)
 {
     return (*this)[ref.row() - 1][ref.column().index - 1];
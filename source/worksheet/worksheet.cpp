@@ -23,8 +23,12 @@
 // @author: see AUTHORS file
 
 #include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <iterator>
 #include <limits>
+#include <set>
+#include <stdexcept>
 
 #include <xyxlnt/cell/cell.hpp>
 #include <xyxlnt/cell/cell_reference.hpp>
@@ -34,6 +38,8 @@
 #include <xyxlnt/utils/datetime.hpp>
 #include <xyxlnt/utils/exceptions.hpp>
 #include <xyxlnt/utils/numeric.hpp>
+#include <xyxlnt/utils/variant.hpp>
+#include <xyxlnt/workbook/memory_usage.hpp>
 #include <xyxlnt/workbook/named_range.hpp>
 #include <xyxlnt/workbook/workbook.hpp>
 #include <xyxlnt/workbook/worksheet_iterator.hpp>
@@ -48,6 +54,7 @@
 #include <detail/constants.hpp>
 #include <detail/default_case.hpp>
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/memory_meter.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <detail/unicode.hpp>
@@ -59,6 +66,371 @@ int points_to_pixels(double points, double dpi)
     return static_cast<int>(std::ceil(points * dpi / 72));
 }
 
+// Describes how inserting or deleting rows or columns moves a single row or column index.
+// Every index at or after min_index moves by amount. When deleting (reverse), the amount
+// indices immediately before min_index are removed.
+struct index_shift
+{
+    xyxlnt::row_or_col_t row_or_col;
+    std::uint32_t min_index;
+    std::uint32_t amount;
+    bool reverse;
+
+    bool deletes(std::uint32_t index) const
+    {
+        return reverse && index < min_index && index >= min_index - amount;
+    }
+
+    std::uint32_t apply(std::uint32_t index) const
+    {
+        if (index < min_index) return index;
+        return reverse ? index - amount : index + amount;
+    }
+};
+
+// Moves pending garbage candidates along with their cells and drops those of deleted cells.
+// Candidates are ordered by row so a row shift only rebuilds the entries after the edit.
+void shift_garbage_candidates(std::set<std::pair<xyxlnt::row_t, xyxlnt::column_t>> &candidates, const index_shift &shift)
+{
+    const auto by_row = shift.row_or_col == xyxlnt::row_or_col_t::row;
+    const auto first_affected = shift.reverse ? shift.min_index - shift.amount : shift.min_index;
+    auto first = by_row
+        ? candidates.lower_bound(std::make_pair(first_affected, xyxlnt::column_t(xyxlnt::constants::min_column())))
+        : candidates.begin();
+
+    std::vector<std::pair<xyxlnt::row_t, xyxlnt::column_t>> shifted;
+
+    for (auto candidate = first; candidate != candidates.end(); ++candidate)
+    {
+        auto moved = *candidate;
+        auto &index = by_row ? moved.first : moved.second.index;
+
+        if (shift.deletes(index)) continue;
+
+        index = shift.apply(index);
+        shifted.push_back(moved);
+    }
+
+    candidates.erase(first, candidates.end());
+    candidates.insert(shifted.begin(), shifted.end());
+}
+
+// Renumbers the keys of an ordered row or column map according to shift. Keys are rewritten in
+// place: every key at or after the shifted index moves by the same amount, so the map stays
+// ordered and no node is relinked. on_delete is called for each entry removed by a deletion and
+// on_move for each entry whose key changed.
+template <typename Map, typename DeleteVisitor, typename MoveVisitor>
+void shift_keys(Map &map, const index_shift &shift, DeleteVisitor on_delete, MoveVisitor on_move)
+{
+    using key_type = typename Map::key_type;
+
+    auto first_moved = map.lower_bound(key_type(shift.min_index));
+
+    if (shift.reverse)
+    {
+        auto first_deleted = map.lower_bound(key_type(shift.min_index - shift.amount));
+
+        for (auto iter = first_deleted; iter != first_moved; ++iter)
+        {
+            on_delete(iter->second);
+        }
+
+        first_moved = map.erase(first_deleted, first_moved);
+    }
+
+    for (auto iter = first_moved; iter != map.end(); ++iter)
+    {
+        iter->first.index = shift.apply(iter->first.index);
+        on_move(iter->second, iter->first.index);
+    }
+}
+
+// Parses a complete cell reference such as "B7" or "$B$7". Function names, defined names and
+// anything else that doesn't look exactly like a cell reference are rejected.
+bool parse_cell_reference(const std::string &text, xyxlnt::cell_reference &result)
+{
+    std::size_t i = 0;
+    const auto absolute_column = i < text.size() && text[i] == '$';
+    if (absolute_column) ++i;
+
+    const auto column_start = i;
+    while (i < text.size() && std::isalpha(static_cast<unsigned char>(text[i])))
+    {
+        ++i;
+    }
+    const auto column_length = i - column_start;
+
+    const auto absolute_row = i < text.size() && text[i] == '$';
+    if (absolute_row) ++i;
+
+    const auto row_start = i;
+    while (i < text.size() && std::isdigit(static_cast<unsigned char>(text[i])))
+    {
+        ++i;
+    }
+    const auto row_length = i - row_start;
+
+    if (i != text.size() || column_length == 0 || column_length > 3 || row_length == 0 || row_length > 7)
+    {
+        return false;
+    }
+
+    const auto column = xyxlnt::column_t::column_index_from_string(text.substr(column_start, column_length));
+    const auto row = static_cast<xyxlnt::row_t>(std::stoul(text.substr(row_start, row_length)));
+
+    if (column > xyxlnt::constants::max_column().index || row < 1 || row > xyxlnt::constants::max_row())
+    {
+        return false;
+    }
+
+    result = xyxlnt::cell_reference(column, row);
+    result.make_absolute(absolute_column, absolute_row);
+
+    return true;
+}
+
+// Applies shift to a single reference. Returns false if the referenced cell was deleted.
+bool shift_reference(xyxlnt::cell_reference &reference, const index_shift &shift)
+{
+    if (shift.row_or_col == xyxlnt::row_or_col_t::row)
+    {
+        if (shift.deletes(reference.row())) return false;
+        reference.row(shift.apply(reference.row()));
+    }
+    else
+    {
+        if (shift.deletes(reference.column_index())) return false;
+        reference.column_index(shift.apply(reference.column_index()));
+    }
+
+    return true;
+}
+
+// Applies shift to both corners of a range. A range loses the deleted rows or columns it
+// overlaps and becomes invalid (returns false) only when all of them are deleted.
+bool shift_range(xyxlnt::cell_reference &top_left, xyxlnt::cell_reference &bottom_right, const index_shift &shift)
+{
+    const auto is_row = shift.row_or_col == xyxlnt::row_or_col_t::row;
+    const auto first = is_row ? top_left.row() : top_left.column_index();
+    const auto last = is_row ? bottom_right.row() : bottom_right.column_index();
+
+    if (shift.deletes(first) && shift.deletes(last)) return false;
+
+    auto new_first = shift.deletes(first) ? shift.min_index - shift.amount : shift.apply(first);
+    auto new_last = shift.deletes(last) ? shift.min_index - shift.amount - 1 : shift.apply(last);
+
+    if (is_row)
+    {
+        top_left.row(new_first);
+        bottom_right.row(new_last);
+    }
+    else
+    {
+        top_left.column_index(new_first);
+        bottom_right.column_index(new_last);
+    }
+
+    return true;
+}
+
+bool is_name_character(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '$';
+}
+
+std::size_t name_end(const std::string &text, std::size_t start)
+{
+    while (start < text.size() && is_name_character(text[start]))
+    {
+        ++start;
+    }
+
+    return start;
+}
+
+// Sheet names are compared without regard to case like Excel does. Only ASCII letters are
+// folded, the bytes of other UTF-8 characters have to match exactly.
+bool same_sheet_title(const std::string &a, const std::string &b)
+{
+    const auto fold = [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; };
+
+    return a.size() == b.size()
+        && std::equal(a.begin(), a.end(), b.begin(), [&fold](char left, char right) {
+               return fold(left) == fold(right);
+           });
+}
+
+// Rewrites the cell references in formula that point into the worksheet titled sheet_title
+// so that they follow a row or column insertion or deletion. Unqualified references only refer
+// to that sheet if the formula itself belongs to it (same_sheet). References to deleted cells
+// become #REF! as they do in Excel. Whole-row and whole-column references are left unchanged.
+std::string shift_formula_references(const std::string &formula, bool same_sheet,
+    const std::string &sheet_title, const index_shift &shift)
+{
+    std::string result;
+    result.reserve(formula.size());
+
+    std::size_t i = 0;
+
+    while (i < formula.size())
+    {
+        const auto c = formula[i];
+
+        if (c == '"')
+        {
+            // string literal, "" is an escaped quote
+            auto end = i + 1;
+
+            while (end < formula.size() && (formula[end] != '"' || (end + 1 < formula.size() && formula[end + 1] == '"')))
+            {
+                end += formula[end] == '"' ? 2 : 1;
+            }
+
+            end = std::min(end + 1, formula.size());
+            result.append(formula, i, end - i);
+            i = end;
+
+            continue;
+        }
+
+        if (c != '\'' && !is_name_character(c))
+        {
+            result.push_back(c);
+            ++i;
+
+            continue;
+        }
+
+        // optional sheet qualifier: Sheet1!A1 or 'Sheet 1'!A1
+        const auto token_start = i;
+        auto qualified = false;
+        std::string sheet;
+
+        if (c == '\'')
+        {
+            auto end = i + 1;
+
+            while (end < formula.size())
+            {
+                if (formula[end] == '\'')
+                {
+                    if (end + 1 < formula.size() && formula[end + 1] == '\'')
+                    {
+                        sheet.push_back('\'');
+                        end += 2;
+                        continue;
+                    }
+                    break;
+                }
+
+                sheet.push_back(formula[end++]);
+            }
+
+            if (end + 1 >= formula.size() || formula[end + 1] != '!')
+            {
+                end = std::min(end + 1, formula.size());
+                result.append(formula, i, end - i);
+                i = end;
+
+                continue;
+            }
+
+            qualified = true;
+            i = end + 2;
+        }
+        else
+        {
+            const auto end = name_end(formula, i);
+
+            if (end < formula.size() && formula[end] == '!')
+            {
+                qualified = true;
+                sheet = formula.substr(i, end - i);
+                i = end + 1;
+            }
+        }
+
+        const auto first_end = name_end(formula, i);
+        xyxlnt::cell_reference top_left;
+
+        if (first_end == i
+            || (first_end < formula.size() && formula[first_end] == '(')
+            || !parse_cell_reference(formula.substr(i, first_end - i), top_left))
+        {
+            result.append(formula, token_start, first_end - token_start);
+            i = std::max(first_end, token_start + 1);
+
+            continue;
+        }
+
+        auto reference_end = first_end;
+        auto is_range = false;
+        xyxlnt::cell_reference bottom_right;
+
+        if (first_end < formula.size() && formula[first_end] == ':')
+        {
+            const auto second_end = name_end(formula, first_end + 1);
+
+            if (parse_cell_reference(formula.substr(first_end + 1, second_end - first_end - 1), bottom_right))
+            {
+                is_range = true;
+                reference_end = second_end;
+            }
+        }
+
+        if (qualified ? !same_sheet_title(sheet, sheet_title) : !same_sheet)
+        {
+            result.append(formula, token_start, reference_end - token_start);
+            i = reference_end;
+
+            continue;
+        }
+
+        result.append(formula, token_start, i - token_start);
+
+        const auto valid = is_range
+            ? shift_range(top_left, bottom_right, shift)
+            : shift_reference(top_left, shift);
+
+        if (!valid)
+        {
+            result.append("#REF!");
+        }
+        else
+        {
+            result.append(top_left.to_string());
+
+            if (is_range)
+            {
+                result.push_back(':');
+                result.append(bottom_right.to_string());
+            }
+        }
+
+        i = reference_end;
+    }
+
+    return result;
+}
+
+// Throws if a block of rows x columns cells starting at top_left would extend past the last
+// row or column of a worksheet. Returns false if the block is empty.
+bool check_block(const xyxlnt::cell_reference &top_left, std::size_t rows, std::size_t columns)
+{
+    if (rows == 0 || columns == 0)
+    {
+        return false;
+    }
+
+    if (rows - 1 > static_cast<std::size_t>(xyxlnt::constants::max_row() - top_left.row())
+        || columns - 1 > static_cast<std::size_t>(xyxlnt::constants::max_column().index - top_left.column_index()))
+    {
+        throw xyxlnt::invalid_parameter();
+    }
+
+    return true;
+}
+
 } // namespace
 
 namespace xyxlnt {
@@ -121,7 +493,14 @@ cell worksheet::operator[](const cell_reference &ref)
 
 std::vector<range_reference> worksheet::merged_ranges() const
 {
-    return d_->merged_cells_;
+    return d_->merged_cells_.ranges();
+}
+
+optional<range_reference> worksheet::merged_range(const cell_reference &ref) const
+{
+    auto match = d_->merged_cells_.find(ref.column(), ref.row());
+
+    return match == nullptr ? optional<range_reference>() : optional<range_reference>(*match);
 }
 
 bool worksheet::has_page_margins() const
@@ -201,19 +580,17 @@ const workbook &worksheet::workbook() const
 
 void worksheet::garbage_collect()
 {
-    auto cell_iter = d_->cell_map_.begin();
-
-    while (cell_iter != d_->cell_map_.end())
+    for (const auto &candidate : d_->garbage_candidates_)
     {
-        if (xyxlnt::cell(&cell_iter->second).garbage_collectible())
-        {
-            cell_iter = d_->cell_map_.erase(cell_iter);
-        }
-        else
+        auto cell = d_->find_cell(candidate.second, candidate.first);
+
+        if (cell != nullptr && cell->is_garbage_collectible())
         {
-            ++cell_iter;
+            d_->erase_cell(candidate.second, candidate.first);
         }
     }
+
+    d_->garbage_candidates_.clear();
 }
 
 void worksheet::id(std::size_t id)
@@ -382,22 +759,25 @@ cell_reference worksheet::active_cell() const
 
 cell worksheet::cell(const cell_reference &reference)
 {
-    auto match = d_->cell_map_.find(reference);
-    if (match == d_->cell_map_.end())
-    {
-        auto impl = detail::cell_impl();
-        impl.parent_ = d_;
-        impl.column_ = reference.column_index();
-        impl.row_ = reference.row();
+    auto &impl = d_->get_or_create_cell(reference.column(), reference.row());
 
-        match = d_->cell_map_.emplace(reference, impl).first;
+    // a new cell is empty until written so the next collection should check it
+    if (impl.is_garbage_collectible())
+    {
+        d_->mark_garbage_candidate(impl.column_, impl.row());
     }
-    return xyxlnt::cell(&match->second);
+
+    return xyxlnt::cell(&impl);
 }
 
 const cell worksheet::cell(const cell_reference &reference) const
 {
-    return xyxlnt::cell(&d_->cell_map_.at(reference));
+    auto match = d_->find_cell(reference.column(), reference.row());
+    if (match == nullptr)
+    {
+        throw std::out_of_range("cell not found: " + reference.to_string());
+    }
+    return xyxlnt::cell(match);
 }
 
 cell worksheet::cell(xyxlnt::column_t column, row_t row)
@@ -412,8 +792,7 @@ const cell worksheet::cell(xyxlnt::column_t column, row_t row) const
 
 bool worksheet::has_cell(const cell_reference &reference) const
 {
-    const auto cell = d_->cell_map_.find(reference);
-    return cell != d_->cell_map_.cend();
+    return d_->find_cell(reference.column(), reference.row()) != nullptr;
 }
 
 bool worksheet::has_row_properties(row_t row) const
@@ -460,9 +839,9 @@ column_t worksheet::lowest_column() const
 
     auto lowest = constants::max_column();
 
-    for (auto &cell : d_->cell_map_)
+    for (auto &row : d_->cell_map_)
     {
-        lowest = std::min(lowest, cell.first.column());
+        lowest = std::min(lowest, row.second.begin()->second.column_);
     }
 
     return lowest;
@@ -492,14 +871,7 @@ row_t worksheet::lowest_row() const
         return constants::min_row();
     }
 
-    auto lowest = constants::max_row();
-
-    for (auto &cell : d_->cell_map_)
-    {
-        lowest = std::min(lowest, cell.first.row());
-    }
-
-    return lowest;
+    return d_->cell_map_.begin()->first;
 }
 
 row_t worksheet::lowest_row_or_props() const
@@ -521,14 +893,12 @@ row_t worksheet::lowest_row_or_props() const
 
 row_t worksheet::highest_row() const
 {
-    auto highest = constants::min_row();
-
-    for (auto &cell : d_->cell_map_)
+    if (d_->cell_map_.empty())
     {
-        highest = std::max(highest, cell.first.row());
+        return constants::min_row();
     }
 
-    return highest;
+    return d_->cell_map_.rbegin()->first;
 }
 
 row_t worksheet::highest_row_or_props() const
@@ -552,9 +922,9 @@ column_t worksheet::highest_column() const
 {
     auto highest = constants::min_column();
 
-    for (auto &cell : d_->cell_map_)
+    for (auto &row : d_->cell_map_)
     {
-        highest = std::max(highest, cell.first.column());
+        highest = std::max(highest, row.second.rbegin()->second.column_);
     }
 
     return highest;
@@ -610,15 +980,18 @@ range_reference worksheet::calculate_dimension(bool skip_null) const
     column_t max_col = constants::min_column();
     row_t min_row = min_row_prop;
     row_t max_row = max_row_prop;
-    for (auto &c : d_->cell_map_)
+    for (auto &row : d_->cell_map_)
     {
         if(skip_null){
-            min_col = std::min(min_col, c.second.column_);
-            min_row = std::min(min_row, c.second.row_);
+            min_col = std::min(min_col, row.second.begin()->second.column_);
         }
-        max_col = std::max(max_col, c.second.column_);
-        max_row = std::max(max_row, c.second.row_);
+        max_col = std::max(max_col, row.second.rbegin()->second.column_);
     }
+    // rows are ordered so the row extents are at either end of the map
+    if(skip_null){
+        min_row = std::min(min_row, d_->cell_map_.begin()->first.index);
+    }
+    max_row = std::max(max_row, d_->cell_map_.rbegin()->first.index);
     return range_reference(min_col, min_row, max_col, max_row);
 }
 
@@ -664,7 +1037,11 @@ void worksheet::unmerge_cells(const std::string &reference_string)
 
 void worksheet::merge_cells(const range_reference &reference)
 {
-    d_->merged_cells_.push_back(reference);
+    if (!d_->merged_cells_.insert(reference))
+    {
+        throw invalid_parameter();
+    }
+
     bool first = true;
 
     for (auto row : range(reference))
@@ -692,15 +1069,11 @@ void worksheet::merge_cells(const range_reference &reference)
 
 void worksheet::unmerge_cells(const range_reference &reference)
 {
-    auto match = std::find(d_->merged_cells_.begin(), d_->merged_cells_.end(), reference);
-
-    if (match == d_->merged_cells_.end())
+    if (!d_->merged_cells_.erase(reference))
     {
         throw invalid_parameter();
     }
 
-    d_->merged_cells_.erase(match);
-
     for (auto row : range(reference))
     {
         for (auto cell : row)
@@ -714,7 +1087,7 @@ row_t worksheet::next_row() const
 {
     auto row = highest_row() + 1;
 
-    if (row == 2 && d_->cell_map_.size() == 0)
+    if (row == 2 && d_->cell_map_.empty())
     {
         row = 1;
     }
@@ -742,6 +1115,138 @@ const xyxlnt::range worksheet::columns(bool skip_null) const
     return xyxlnt::range(*this, calculate_dimension(skip_null), major_order::column, skip_null);
 }
 
+void worksheet::write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns,
+    const double *values, std::size_t row_stride)
+{
+    if (!check_block(top_left, rows, columns)) return;
+    if (row_stride == 0) row_stride = columns;
+
+    d_->fill_block(top_left.column(), top_left.row(), rows, columns,
+        [values, row_stride](detail::cell_impl &impl, std::size_t r, std::size_t c) {
+            impl.release_shared_string();
+            impl.type_ = cell::type::number;
+            impl.value_numeric_ = values[r * row_stride + c];
+        });
+}
+
+void worksheet::write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns,
+    const std::string *values, std::size_t row_stride)
+{
+    if (!check_block(top_left, rows, columns)) return;
+    if (row_stride == 0) row_stride = columns;
+
+    d_->fill_block(top_left.column(), top_left.row(), rows, columns,
+        [values, row_stride](detail::cell_impl &impl, std::size_t r, std::size_t c) {
+            xyxlnt::cell(&impl).value(values[r * row_stride + c]);
+        });
+}
+
+void worksheet::write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns,
+    const variant *values, std::size_t row_stride)
+{
+    if (!check_block(top_left, rows, columns)) return;
+    if (row_stride == 0) row_stride = columns;
+
+    d_->fill_block(top_left.column(), top_left.row(), rows, columns,
+        [values, row_stride](detail::cell_impl &impl, std::size_t r, std::size_t c) {
+            const auto &value = values[r * row_stride + c];
+            auto target = xyxlnt::cell(&impl);
+
+            switch (value.value_type())
+            {
+            case variant::type::null:
+                target.clear_value();
+                break;
+            case variant::type::i4:
+                target.value(value.get<std::int32_t>());
+                break;
+            case variant::type::lpstr:
+                target.value(value.get<std::string>());
+                break;
+            case variant::type::date:
+                target.value(value.get<datetime>());
+                break;
+            case variant::type::boolean:
+                target.value(value.get<bool>());
+                break;
+            case variant::type::vector:
+                throw invalid_parameter();
+            }
+        });
+}
+
+void worksheet::read_block(const range_reference &block, double *values, cell_type *types, major_order order) const
+{
+    const auto rows = static_cast<std::size_t>(block.height());
+    const auto columns = static_cast<std::size_t>(block.width());
+    const auto row_step = order == major_order::row ? columns : 1;
+    const auto column_step = order == major_order::row ? 1 : rows;
+
+    std::fill(values, values + rows * columns, std::numeric_limits<double>::quiet_NaN());
+
+    if (types != nullptr)
+    {
+        std::fill(types, types + rows * columns, cell_type::empty);
+    }
+
+    d_->visit_block(block.top_left().column(), block.top_left().row(),
+        block.bottom_right().column(), block.bottom_right().row(),
+        [=](const detail::cell_impl &impl, std::size_t r, std::size_t c) {
+            const auto index = r * row_step + c * column_step;
+
+            if (impl.type_ == cell_type::number || impl.type_ == cell_type::date || impl.type_ == cell_type::boolean)
+            {
+                values[index] = impl.value_numeric_;
+            }
+
+            if (types != nullptr)
+            {
+                types[index] = impl.type_;
+            }
+        });
+}
+
+void worksheet::read_block(const range_reference &block, std::string *values, cell_type *types, major_order order) const
+{
+    const auto rows = static_cast<std::size_t>(block.height());
+    const auto columns = static_cast<std::size_t>(block.width());
+    const auto row_step = order == major_order::row ? columns : 1;
+    const auto column_step = order == major_order::row ? 1 : rows;
+    const auto &shared_strings = workbook().shared_strings();
+
+    std::fill(values, values + rows * columns, std::string());
+
+    if (types != nullptr)
+    {
+        std::fill(types, types + rows * columns, cell_type::empty);
+    }
+
+    d_->visit_block(block.top_left().column(), block.top_left().row(),
+        block.bottom_right().column(), block.bottom_right().row(),
+        [=, &shared_strings](const detail::cell_impl &impl, std::size_t r, std::size_t c) {
+            const auto index = r * row_step + c * column_step;
+
+            switch (impl.type_)
+            {
+            case cell_type::shared_string:
+                values[index] = shared_strings.at(static_cast<std::size_t>(impl.value_numeric_)).plain_text();
+                break;
+            case cell_type::inline_string:
+            case cell_type::formula_string:
+            case cell_type::error:
+                values[index] = impl.value_text_.plain_text();
+                break;
+            default:
+                break;
+            }
+
+            if (types != nullptr)
+            {
+                types[index] = impl.type_;
+            }
+        });
+}
+
 /*
 //TODO: finish implementing cell_iterator wrapping before uncommenting
 
@@ -760,23 +1265,29 @@ const cell_vector worksheet::cells(bool skip_null) const
 
 void worksheet::clear_cell(const cell_reference &ref)
 {
-    d_->cell_map_.erase(ref);
+    if (auto impl = d_->find_cell(ref.column(), ref.row()))
+    {
+        impl->detach();
+    }
+
+    d_->erase_cell(ref.column(), ref.row());
     // TODO: garbage collect newly unreferenced resources such as styles?
 }
 
 void worksheet::clear_row(row_t row)
 {
-    for (auto it = d_->cell_map_.begin(); it != d_->cell_map_.end();)
+    auto row_iter = d_->cell_map_.find(row);
+
+    if (row_iter != d_->cell_map_.end())
     {
-        if (it->first.row() == row)
-        {
-            it = d_->cell_map_.erase(it);
-        }
-        else
+        for (auto &cell : row_iter->second)
         {
-            ++it;
+            cell.second.detach();
         }
+
+        d_->cell_map_.erase(row_iter);
     }
+
     d_->row_properties_.erase(row);
     // TODO: garbage collect newly unreferenced resources such as styles?
 }
@@ -813,52 +1324,72 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
         throw xyxlnt::exception("Cannot move cells as they would be outside the maximum bounds of the spreadsheet");
     }
 
-    std::vector<detail::cell_impl> cells_to_move;
+    const auto shift = index_shift{row_or_col, min_index, amount, reverse};
 
-    auto cell_iter = d_->cell_map_.cbegin();
-    while (cell_iter != d_->cell_map_.cend())
-    {
-        std::uint32_t current_index;
-        switch (row_or_col)
+    shift_garbage_candidates(d_->garbage_candidates_, shift);
+
+    auto delete_cell = [this](detail::cell_impl &cell) {
+        cell.detach();
+
+        if (cell.comment_.is_set())
         {
-        case row_or_col_t::row:
-            current_index = cell_iter->first.row();
-            break;
-        case row_or_col_t::column:
-            current_index = cell_iter->first.column().index;
-            break;
-        default:
-            throw xyxlnt::unhandled_switch_case();
+            d_->comments_.erase(cell_reference(cell.column_, cell.row()).to_string());
         }
+    };
 
-        if (current_index >= min_index) // extract cells to be moved
-        {
-            auto cell = cell_iter->second;
-            if (row_or_col == row_or_col_t::row)
-            {
-                cell.row_ = reverse ? cell.row_ - amount : cell.row_ + amount;
-            }
-            else if (row_or_col == row_or_col_t::column)
-            {
-                cell.column_ = reverse ? cell.column_.index - amount : cell.column_.index + amount;
-            }
+    if (row_or_col == row_or_col_t::row)
+    {
+        // cells find their row through its key so renumbering the rows moves them
+        shift_keys(
+            d_->cell_map_, shift,
+            [&delete_cell](detail::cell_row &cells) {
+                for (auto &cell : cells)
+                {
+                    delete_cell(cell.second);
+                }
+            },
+            [](detail::cell_row &, std::uint32_t) {});
+    }
+    else
+    {
+        auto row_iter = d_->cell_map_.begin();
 
-            cells_to_move.push_back(cell);
-            cell_iter = d_->cell_map_.erase(cell_iter);
-        }
-        else if (reverse && current_index >= min_index - amount) // delete destination cells
+        while (row_iter != d_->cell_map_.end())
         {
-            cell_iter = d_->cell_map_.erase(cell_iter);
+            shift_keys(row_iter->second, shift, delete_cell,
+                [](detail::cell_impl &cell, std::uint32_t new_column) {
+                    cell.column_ = new_column;
+                });
+
+            row_iter = row_iter->second.empty() ? d_->cell_map_.erase(row_iter) : std::next(row_iter);
         }
-        else // skip other cells
+    }
+
+    // comments are keyed by the reference of their cell so the moved ones are re-keyed,
+    // all taken out first so that none overwrites another that hasn't moved yet
+    std::vector<std::pair<cell_reference, xyxlnt::comment>> moved_comments;
+
+    for (auto comment_iter = d_->comments_.begin(); comment_iter != d_->comments_.end();)
+    {
+        const auto reference = cell_reference(comment_iter->first);
+        auto moved = reference;
+        shift_reference(moved, shift);
+
+        if (moved == reference)
         {
-            ++cell_iter;
+            ++comment_iter;
+            continue;
         }
+
+        moved_comments.emplace_back(moved, std::move(comment_iter->second));
+        comment_iter = d_->comments_.erase(comment_iter);
     }
 
-    for (auto &cell : cells_to_move)
+    for (auto &moved_comment : moved_comments)
     {
-        d_->cell_map_[cell_reference(cell.column_, cell.row_)] = cell;
+        auto &comment = d_->comments_[moved_comment.first.to_string()];
+        comment = std::move(moved_comment.second);
+        d_->find_cell(moved_comment.first.column(), moved_comment.first.row())->comment_ = &comment;
     }
 
     if (row_or_col == row_or_col_t::row)
@@ -920,35 +1451,51 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
         }
     }
 
-    // adjust merged cells
-    auto shift_reference = [min_index, amount, row_or_col, reverse](cell_reference &ref) {
-        auto index = row_or_col == row_or_col_t::row ? ref.row() : ref.column_index();
-        if (index >= min_index)
+    // adjust merged cells, dropping merges whose cells were all deleted
+    if (!d_->merged_cells_.empty())
+    {
+        const auto merged = d_->merged_cells_.ranges();
+        d_->merged_cells_.clear();
+
+        for (const auto &merged_range : merged)
         {
-            auto new_index = reverse ? index - amount : index + amount;
-            if (row_or_col == row_or_col_t::row)
-            {
-                ref.row(new_index);
-            }
-            else if (row_or_col == row_or_col_t::column)
+            auto new_top_left = merged_range.top_left();
+            auto new_bottom_right = merged_range.bottom_right();
+
+            if (shift_range(new_top_left, new_bottom_right, shift))
             {
-                ref.column_index(new_index);
+                d_->merged_cells_.insert(range_reference(new_top_left, new_bottom_right));
             }
         }
-    };
+    }
 
-    for (auto merged_cell = d_->merged_cells_.begin(); merged_cell != d_->merged_cells_.end(); ++merged_cell)
+    // adjust formulae and internal hyperlinks anywhere in the workbook that refer to this sheet
+    const auto sheet_title = title();
+
+    for (auto impl : workbook().d_->reference_cells())
     {
-        cell_reference new_top_left = merged_cell->top_left();
-        shift_reference(new_top_left);
+        if (impl->formula_.is_set())
+        {
+            auto &formula = impl->formula_.get();
+            auto shifted = shift_formula_references(formula, impl->parent_ == d_, sheet_title, shift);
 
-        cell_reference new_bottom_right = merged_cell->bottom_right();
-        shift_reference(new_bottom_right);
+            if (shifted != formula)
+            {
+                formula = std::move(shifted);
+            }
+        }
 
-        range_reference new_range{new_top_left, new_bottom_right};
-        if (*merged_cell != new_range)
+        if (impl->hyperlink_.is_set()
+            && impl->hyperlink_.get().relationship.target_mode() == target_mode::internal)
         {
-            *merged_cell = new_range;
+            auto &relationship = impl->hyperlink_.get().relationship;
+            auto target = shift_formula_references(relationship.target().to_string(), false, sheet_title, shift);
+
+            if (target != relationship.target().to_string())
+            {
+                relationship = xyxlnt::relationship(relationship.id(), relationship.type(),
+                    relationship.source(), uri(target), target_mode::internal);
+            }
         }
     }
 }
@@ -967,25 +1514,30 @@ bool worksheet::compare(const worksheet &other, bool reference) const
 
     if (d_->parent_ != other.d_->parent_) return false;
 
-    for (auto &cell : d_->cell_map_)
+    for (auto &row : d_->cell_map_)
     {
-        if (other.d_->cell_map_.find(cell.first) == other.d_->cell_map_.end())
+        for (auto &cell : row.second)
         {
-            return false;
-        }
+            auto other_impl = other.d_->find_cell(cell.second.column_, row.first);
 
-        xyxlnt::cell this_cell(&cell.second);
-        xyxlnt::cell other_cell(&other.d_->cell_map_[cell.first]);
+            if (other_impl == nullptr)
+            {
+                return false;
+            }
 
-        if (this_cell.data_type() != other_cell.data_type())
-        {
-            return false;
-        }
+            xyxlnt::cell this_cell(&cell.second);
+            xyxlnt::cell other_cell(other_impl);
 
-        if (this_cell.data_type() == xyxlnt::cell::type::number
-            && !detail::float_equals(this_cell.value<double>(), other_cell.value<double>()))
-        {
-            return false;
+            if (this_cell.data_type() != other_cell.data_type())
+            {
+                return false;
+            }
+
+            if (this_cell.data_type() == xyxlnt::cell::type::number
+                && !detail::float_equals(this_cell.value<double>(), other_cell.value<double>()))
+            {
+                return false;
+            }
         }
     }
 
@@ -1040,9 +1592,14 @@ void worksheet::remove_named_range(const std::string &name)
     d_->named_ranges_.erase(name);
 }
 
-void worksheet::reserve(std::size_t n)
+void worksheet::reserve(std::size_t /*n*/)
+{
+    // cells are stored in ordered row nodes which can't be preallocated
+}
+
+memory_usage worksheet::memory_usage() const
 {
-    d_->cell_map_.reserve(n);
+    return detail::memory_meter::measure(*d_);
 }
 
 class header_footer worksheet::header_footer() const
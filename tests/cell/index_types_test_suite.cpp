@@ -24,6 +24,7 @@
 #include <iostream>
 
 #include <helpers/test_suite.hpp>
+#include <xyxlnt/cell/cell_reference.hpp>
 
 
 class index_types_test_suite : public test_suite
@@ -36,6 +37,8 @@ public:
         register_test(test_bad_string_numbers);
         register_test(test_bad_index_zero);
         register_test(test_column_operators);
+        register_test(test_column_strings);
+        register_test(test_cell_reference_strings);
     }
 
     void test_bad_string_empty()
@@ -100,6 +103,33 @@ public:
         xyxlnt_assert(3 <= c1);
         xyxlnt_assert(!(4 <= c1));
     }
+
+    void test_column_strings()
+    {
+        xyxlnt_assert_equals(xyxlnt::column_t::column_string_from_index(1), "A");
+        xyxlnt_assert_equals(xyxlnt::column_t::column_string_from_index(26), "Z");
+        xyxlnt_assert_equals(xyxlnt::column_t::column_string_from_index(27), "AA");
+        xyxlnt_assert_equals(xyxlnt::column_t::column_string_from_index(16384), "XFD");
+        xyxlnt_assert_equals(xyxlnt::column_t::column_string_from_index(16385), "XFE");
+        xyxlnt_assert_equals(xyxlnt::column_t::column_string_from_index(18278), "ZZZ");
+        xyxlnt_assert_equals(xyxlnt::column_t::column_string_from_index(18279), "AAAA");
+
+        for (xyxlnt::column_t::index_t index = 1; index <= 18278; ++index)
+        {
+            const auto string = xyxlnt::column_t::column_string_from_index(index);
+            xyxlnt_assert_equals(xyxlnt::column_t::column_index_from_string(string), index);
+        }
+    }
+
+    void test_cell_reference_strings()
+    {
+        xyxlnt_assert_equals(xyxlnt::cell_reference(1, 1).to_string(), "A1");
+        xyxlnt_assert_equals(xyxlnt::cell_reference(16384, 1048576).to_string(), "XFD1048576");
+        xyxlnt_assert_equals(xyxlnt::cell_reference("$B$12").to_string(), "$B$12");
+        xyxlnt_assert_equals(xyxlnt::cell_reference("C$3").to_string(), "C$3");
+        xyxlnt_assert_equals(xyxlnt::cell_reference("$D4").to_string(), "$D4");
+        xyxlnt_assert_equals(xyxlnt::cell_reference(16385, 4294967295u).to_string(), "XFE4294967295");
+    }
 };
 
 static index_types_test_suite x{};
@@ -28,6 +28,7 @@
 #include <helpers/test_suite.hpp>
 
 #include <xyxlnt/cell/rich_text.hpp>
+#include <xyxlnt/workbook/workbook.hpp>
 
 class rich_text_test_suite : public test_suite
 {
@@ -38,6 +39,7 @@ public:
         register_test(test_runs);
         register_test(test_phonetic_runs);
         register_test(test_phonetic_properties);
+        register_test(test_hash);
     }
 
     void test_operators()
@@ -142,5 +144,32 @@ public:
         xyxlnt_assert_equals(rt.phonetic_properties().has_type(), true);
         xyxlnt_assert_equals(rt.phonetic_properties().has_alignment(), true);
     }
+
+    void test_hash()
+    {
+        xyxlnt::rich_text_hash hash;
+        xyxlnt_assert_equals(hash(xyxlnt::rich_text("abc")), hash(std::string("abc")));
+
+        xyxlnt::rich_text forward;
+        forward.add_run({"a", {}, false});
+        forward.add_run({"b", {}, false});
+        xyxlnt::rich_text backward;
+        backward.add_run({"b", {}, false});
+        backward.add_run({"a", {}, false});
+        xyxlnt_assert_differs(hash(forward), hash(backward));
+
+        xyxlnt::rich_text bold("abc", xyxlnt::font().bold(true));
+        xyxlnt_assert_differs(hash(bold), hash(xyxlnt::rich_text("abc")));
+
+        xyxlnt::workbook wb;
+        wb.add_shared_string(xyxlnt::rich_text("dup"), true);
+        wb.add_shared_string(xyxlnt::rich_text("dup"), true);
+        xyxlnt_assert_equals(wb.add_shared_string(bold), 2);
+        xyxlnt_assert_equals(wb.add_shared_string(std::string("dup")), 0);
+        xyxlnt_assert_equals(wb.add_shared_string(xyxlnt::rich_text("abc")), 3);
+        xyxlnt_assert_equals(wb.add_shared_string(std::string("abc")), 3);
+        xyxlnt_assert_equals(wb.add_shared_string(bold), 2);
+        xyxlnt_assert_equals(wb.shared_strings().size(), 4);
+    }
 };
 static rich_text_test_suite x{};
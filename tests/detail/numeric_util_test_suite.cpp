@@ -21,6 +21,13 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
 #include <xyxlnt/utils/numeric.hpp>
 #include <helpers/test_suite.hpp>
 
@@ -30,6 +37,7 @@ public:
     numeric_test_suite()
     {
         register_test(test_serialise_number);
+        register_test(test_serialise_matches_printf);
         register_test(test_float_equals_zero);
         register_test(test_float_equals_large);
         register_test(test_float_equals_fairness);
@@ -54,6 +62,36 @@ public:
         xyxlnt_assert(serialiser.serialise(1.23456789012345e-67) == "1.23456789012345e-67");
     }
 
+    void test_serialise_matches_printf()
+    {
+        xyxlnt::detail::number_serialiser serialiser;
+        std::mt19937_64 generator(2021);
+        std::uniform_real_distribution<double> mantissa(1.0, 10.0);
+        std::vector<double> values{0.0, -0.0, 0.5, 2.5, 0.1, 1e-5, 1e15, 1e15 - 1, 999999999999999.5,
+            1000000000000005.0, 4503599627370497.0, 1e22, 1e23, 1e-8, 1e36, 1e300, 5e-324,
+            std::numeric_limits<double>::infinity(), std::numeric_limits<double>::max()};
+
+        for (int exponent = -12; exponent <= 40; ++exponent)
+        {
+            for (int i = 0; i < 500; ++i)
+            {
+                values.push_back(mantissa(generator) * std::pow(10.0, exponent));
+                values.push_back(-std::floor(mantissa(generator) * std::pow(10.0, exponent)));
+            }
+        }
+
+        for (auto value : values)
+        {
+            char expected[32];
+            auto expected_length = std::snprintf(expected, sizeof(expected), "%.15g", value);
+            xyxlnt_assert_equals(serialiser.serialise(value), std::string(expected, static_cast<std::size_t>(expected_length)));
+
+            char written[32];
+            auto length = serialiser.serialise(value, written, sizeof(written));
+            xyxlnt_assert_equals(std::string(written, length), std::string(expected, static_cast<std::size_t>(expected_length)));
+        }
+    }
+
     void test_float_equals_zero()
     {
         // comparing relatively small numbers (2.3e-6) with 0 will be true by default
@@ -22,9 +22,12 @@
 // @author: see AUTHORS file
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <helpers/test_suite.hpp>
 
+#include <detail/number_format/number_formatter.hpp>
 #include <xyxlnt/styles/number_format.hpp>
 #include <xyxlnt/utils/date.hpp>
 #include <xyxlnt/utils/time.hpp>
@@ -115,6 +118,8 @@ public:
         register_test(test_builtin_format_date_dmyminus);
         register_test(test_builtin_format_date_dmminus);
         register_test(test_builtin_format_date_myminus);
+        register_test(test_copies_share_parsed_format);
+        register_test(test_format_numbers_matches_format_number);
     }
 
     void test_basic()
@@ -1032,5 +1037,50 @@ public:
     {
         format_and_test(xyxlnt::number_format::date_myminus(), {{"5-16", "###########", "1-00", "text"}});
     }
+
+    void test_format_numbers_matches_format_number()
+    {
+        const std::vector<double> numbers{0.0, -0.0, 1.0, -1.0, 0.125, 1.239, 123.0, -1234.5,
+            999999.999, 45000.75, 0.005, 1e-7, 12345678.9, 60.5, 2958465.99999};
+
+        std::vector<std::string> format_strings{"#,##0.00 \"units\"", "0.0;[Red]-0.0;\"zero\"",
+            "[>100]0;0.00", "yy-m-d hh:mm AM/PM", "0.00E+00", "# ?/?"};
+
+        for (std::size_t id = 0; id < 50; ++id)
+        {
+            if (xyxlnt::number_format::is_builtin_format(id))
+            {
+                format_strings.push_back(xyxlnt::number_format(id).format_string());
+            }
+        }
+
+        for (const auto &format_string : format_strings)
+        {
+            xyxlnt::detail::number_formatter formatter(format_string, xyxlnt::calendar::windows_1900);
+            xyxlnt::detail::formatted_numbers output;
+            formatter.format_numbers(numbers.data(), numbers.size(), output);
+            xyxlnt_assert_equals(output.size(), numbers.size());
+
+            for (std::size_t i = 0; i < numbers.size(); ++i)
+            {
+                xyxlnt_assert_equals(output.at(i), formatter.format_number(numbers[i]));
+            }
+        }
+    }
+
+    void test_copies_share_parsed_format()
+    {
+        xyxlnt::number_format original("0.00");
+        xyxlnt_assert_equals(original.format(1.5, xyxlnt::calendar::windows_1900), "1.50");
+        xyxlnt_assert(!original.is_date_format());
+
+        // changing a copy must not change the format parsed for the original
+        auto copy = original;
+        copy.format_string("yyyy-mm-dd");
+        xyxlnt_assert(copy.is_date_format());
+        xyxlnt_assert_equals(copy.format(42000, xyxlnt::calendar::windows_1900), "2014-12-27");
+        xyxlnt_assert_equals(original.format(2.25, xyxlnt::calendar::windows_1900), "2.25");
+        xyxlnt_assert(!original.is_date_format());
+    }
 };
 static number_format_test_suite x;
@@ -22,6 +22,7 @@
 // @author: see AUTHORS file
 
 #include <iostream>
+#include <vector>
 
 #include <helpers/test_suite.hpp>
 #include <xyxlnt/utils/date.hpp>
@@ -41,6 +42,7 @@ public:
         register_test(test_mac_calendar);
         register_test(test_operators);
         register_test(test_weekday);
+        register_test(test_batch_conversion);
     }
 
     void test_from_string()
@@ -122,6 +124,40 @@ public:
         xyxlnt_assert_equals(xyxlnt::date(2018, 10, 29).weekday(), 1); // October 29th 2018 was Monday
         xyxlnt_assert_equals(xyxlnt::date(1970, 1, 1).weekday(), 4); // January 1st 1970 was a Thursday
     }
+
+    void test_batch_conversion()
+    {
+        const auto base_date = xyxlnt::calendar::windows_1900;
+        std::vector<double> numbers;
+
+        // every day of 1900 including the leap year bug, then a timestamp every few days up to 9999-12-31
+        for (auto day = 1; day <= 400; ++day)
+        {
+            numbers.push_back(day);
+        }
+
+        for (auto number = 400.25; number < 2958466; number += 3.0001)
+        {
+            numbers.push_back(number);
+        }
+
+        std::vector<xyxlnt::datetime> datetimes(numbers.size(), xyxlnt::datetime(1900, 1, 1));
+        xyxlnt::datetime::from_numbers(numbers.data(), numbers.size(), base_date, datetimes.data());
+
+        xyxlnt_assert_equals(datetimes[59], xyxlnt::datetime(1900, 2, 29));
+        xyxlnt_assert_equals(datetimes[60], xyxlnt::datetime(1900, 3, 1));
+        xyxlnt_assert_equals(datetimes.back().year, 9999);
+
+        std::vector<double> round_trip(datetimes.size());
+        xyxlnt::datetime::to_numbers(datetimes.data(), datetimes.size(), base_date, round_trip.data());
+
+        for (std::size_t i = 0; i < numbers.size(); ++i)
+        {
+            xyxlnt_assert_equals(datetimes[i], xyxlnt::datetime::from_number(numbers[i], base_date));
+            xyxlnt_assert_equals(round_trip[i], datetimes[i].to_number(base_date));
+            xyxlnt_assert_delta(round_trip[i], numbers[i], 1e-9);
+        }
+    }
 };
 
 static datetime_test_suite x;
@@ -66,6 +66,11 @@ public:
         register_test(test_round_trip_rw_encrypted_numbers);
         register_test(test_streaming_read);
         register_test(test_streaming_write);
+        register_test(test_streaming_write_many_rows);
+        register_test(test_sheet_data_escaping);
+        register_test(test_sparse_sheet_data);
+        register_test(test_save_worksheets_concurrently);
+        register_test(test_profile_load_and_save);
         register_test(test_load_save_german_locale);
         register_test(test_Issue445_inline_str_load);
         register_test(test_Issue445_inline_str_streaming_read);
@@ -710,6 +715,214 @@ public:
         auto c3 = writer.add_cell("C3");
         b2.value("should not change");
         c3.value("C3!");
+
+        auto d3 = writer.add_cell("D3");
+        d3.value(3.5);
+        xyxlnt_assert_throws(writer.add_cell("A3"), xyxlnt::invalid_parameter);
+
+        writer.add_worksheet("second");
+        writer.add_cell("A1").value("C3!");
+        writer.add_cell("A2").value(true);
+
+        writer.close();
+
+        xyxlnt::workbook wb;
+        wb.load(path);
+        xyxlnt_assert_equals(wb.sheet_count(), 2);
+
+        auto ws = wb.sheet_by_title("stream");
+        xyxlnt_assert_equals(ws.cell("B2").value<std::string>(), "B2!");
+        xyxlnt_assert_equals(ws.cell("C3").value<std::string>(), "C3!");
+        xyxlnt_assert_equals(ws.cell("D3").value<double>(), 3.5);
+
+        auto second = wb.sheet_by_title("second");
+        xyxlnt_assert_equals(second.cell("A1").value<std::string>(), "C3!");
+        xyxlnt_assert(second.cell("A2").value<bool>());
+    }
+
+    void test_streaming_write_many_rows()
+    {
+        std::vector<std::uint8_t> data;
+
+        {
+            xyxlnt::streaming_workbook_writer writer;
+            writer.open(data);
+
+            for (xyxlnt::row_t row = 1; row <= 2000; ++row)
+            {
+                writer.add_cell(xyxlnt::cell_reference(1, row)).value(static_cast<int>(row));
+                writer.add_cell(xyxlnt::cell_reference(2, row)).value("row " + std::to_string(row));
+            }
+        }
+
+        xyxlnt::workbook wb;
+        wb.load(data);
+        auto ws = wb.active_sheet();
+
+        xyxlnt_assert_equals(ws.title(), "Sheet1");
+        xyxlnt_assert_equals(ws.highest_row(), 2000);
+        xyxlnt_assert_equals(ws.cell("A1234").value<int>(), 1234);
+        xyxlnt_assert_equals(ws.cell("B2000").value<std::string>(), "row 2000");
+    }
+
+    void test_sheet_data_escaping()
+    {
+        xyxlnt::workbook original;
+        auto ws = original.active_sheet();
+        ws.cell("A1").value("<tag attr=\"1\"> & more\r\n");
+        ws.cell("B1").formula("=IF(A2<1,\"a&b\",\"\")");
+        ws.cell("C2").value(-0.1);
+        ws.cell("D2").number_format(xyxlnt::number_format::percentage());
+
+        // dyDescent on a row below every cell still needs the x14ac prefix declared
+        xyxlnt::row_properties props;
+        props.dy_descent = 0.25;
+        ws.add_row_properties(10, props);
+
+        std::vector<std::uint8_t> data;
+        original.save(data);
+
+        xyxlnt::workbook wb;
+        wb.load(data);
+        ws = wb.active_sheet();
+
+        xyxlnt_assert_equals(ws.cell("A1").value<std::string>(), "<tag attr=\"1\"> & more\r\n");
+        xyxlnt_assert_equals(ws.cell("B1").formula(), "IF(A2<1,\"a&b\",\"\")");
+        xyxlnt_assert_equals(ws.cell("C2").value<double>(), -0.1);
+        xyxlnt_assert(ws.cell("D2").has_format());
+        xyxlnt_assert_equals(ws.cell("D2").data_type(), xyxlnt::cell::type::empty);
+        xyxlnt_assert(ws.has_row_properties(10));
+        xyxlnt_assert_equals(ws.row_properties(10).dy_descent.get(), 0.25);
+    }
+
+    void test_sparse_sheet_data()
+    {
+        xyxlnt::workbook original;
+        auto ws = original.active_sheet();
+        ws.cell("C16").value(1);
+        ws.cell("Z17"); // created but never written
+        ws.cell("XFD17").value(2);
+        ws.cell("B1000").hyperlink("http://example.com");
+        ws.cell("F50000").comment(xyxlnt::comment("note", "author"));
+        ws.cell("F50000").value(3);
+
+        xyxlnt::row_properties props;
+        props.height = 20;
+        props.custom_height = true;
+        ws.add_row_properties(20, props);
+        ws.add_row_properties(1000, props);
+        ws.add_row_properties(60000, props);
+
+        std::vector<std::uint8_t> data;
+        original.save(data);
+
+        xyxlnt::workbook wb;
+        wb.load(data);
+        ws = wb.active_sheet();
+
+        xyxlnt_assert_equals(ws.cell("C16").value<int>(), 1);
+        xyxlnt_assert(!ws.has_cell("Z17"));
+        xyxlnt_assert_equals(ws.cell("XFD17").value<int>(), 2);
+        xyxlnt_assert(ws.cell("B1000").has_hyperlink());
+        xyxlnt_assert_equals(ws.cell("F50000").comment().plain_text(), "note");
+        xyxlnt_assert_equals(ws.cell("F50000").value<int>(), 3);
+        xyxlnt_assert_equals(ws.row_properties(20).height.get(), 20);
+        xyxlnt_assert_equals(ws.row_properties(1000).height.get(), 20);
+        xyxlnt_assert_equals(ws.row_properties(60000).height.get(), 20);
+    }
+
+    void test_save_worksheets_concurrently()
+    {
+        xyxlnt::save_options serial;
+        xyxlnt::save_options concurrent;
+        concurrent.worksheet_threads = 4;
+
+        // comments, hyperlinks, drawings and images are written with their worksheet
+        for (const auto &file : {"10_comments_hyperlinks_formulae.xlsx", "14_images.xlsx"})
+        {
+            xyxlnt::workbook wb;
+            wb.load(path_helper::test_file(file));
+
+            std::vector<std::uint8_t> expected;
+            wb.save(expected, serial);
+            std::vector<std::uint8_t> actual;
+            wb.save(actual, concurrent);
+
+            xyxlnt_assert(actual == expected);
+        }
+
+        xyxlnt::workbook wb;
+
+        for (auto sheet = 0; sheet < 6; ++sheet)
+        {
+            auto ws = sheet == 0 ? wb.active_sheet() : wb.create_sheet();
+
+            for (xyxlnt::row_t row = 1; row <= 200; ++row)
+            {
+                ws.cell(1, row).value(sheet * 1000 + static_cast<int>(row));
+                ws.cell(2, row).value("sheet " + std::to_string(sheet));
+            }
+        }
+
+        std::vector<std::uint8_t> expected;
+        wb.save(expected, serial);
+        std::vector<std::uint8_t> actual;
+        wb.save(actual, concurrent);
+
+        xyxlnt_assert(actual == expected);
+
+        xyxlnt::workbook loaded;
+        loaded.load(actual);
+        xyxlnt_assert_equals(loaded.sheet_count(), 6);
+        xyxlnt_assert_equals(loaded.sheet_by_index(5).cell("A200").value<int>(), 5200);
+    }
+
+    void test_profile_load_and_save()
+    {
+        auto check_parts = [](const xyxlnt::serialization_profile &profile, bool concurrent) {
+            std::chrono::nanoseconds parts_duration(0);
+            std::uint64_t cells = 0;
+
+            for (const auto &part : profile.parts)
+            {
+                xyxlnt_assert(part.uncompressed_bytes > 0);
+                xyxlnt_assert(part.compressed_bytes > 0);
+                xyxlnt_assert(part.compression_duration <= part.duration);
+                parts_duration += part.duration;
+
+                if (part.part.filename() == "sheet1.xml")
+                {
+                    cells += part.cells;
+                }
+            }
+
+            // parts measured on other threads overlap
+            xyxlnt_assert(concurrent || parts_duration <= profile.duration);
+
+            return cells;
+        };
+
+        xyxlnt::serialization_profile profile;
+        xyxlnt::load_options load_options;
+        load_options.profile = &profile;
+
+        xyxlnt::workbook wb;
+        wb.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"), load_options);
+        xyxlnt_assert(profile.parts.size() > 5);
+        const auto cells = check_parts(profile, false);
+        xyxlnt_assert(cells > 0);
+
+        for (std::size_t threads = 1; threads <= 4; threads += 3)
+        {
+            xyxlnt::save_options save_options;
+            save_options.worksheet_threads = threads;
+            save_options.profile = &profile;
+
+            std::vector<std::uint8_t> data;
+            wb.save(data, save_options);
+            xyxlnt_assert(profile.parts.size() > 5);
+            xyxlnt_assert_equals(check_parts(profile, threads > 1), cells);
+        }
     }
 
     void test_load_save_german_locale()
@@ -26,6 +26,8 @@
 
 #include <xyxlnt/xyxlnt.hpp>
 #include <detail/serialization/open_stream.hpp>
+#include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/zstream.hpp>
 #include <helpers/temporary_file.hpp>
 #include <helpers/test_suite.hpp>
 
@@ -65,6 +67,11 @@ public:
         register_test(test_manifest);
         register_test(test_memory);
         register_test(test_clear);
+        register_test(test_restyle_reuses_formats);
+        register_test(test_shared_string_count);
+        register_test(test_compact_shared_strings);
+        register_test(test_memory_usage);
+        register_test(test_format_by_index);
         register_test(test_comparison);
         register_test(test_id_gen);
         register_test(test_load_file);
@@ -434,6 +441,205 @@ public:
         xyxlnt_assert(wb.sheet_titles().empty());
     }
 
+    void test_restyle_reuses_formats()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xyxlnt::row_t row = 1; row <= 500; ++row)
+        {
+            auto cell = ws.cell(1, row);
+            cell.value(static_cast<int>(row));
+            cell.font(xyxlnt::font().bold(true));
+            cell.font(xyxlnt::font().italic(true));
+            cell.fill(xyxlnt::fill::solid(xyxlnt::color::red()));
+        }
+
+        xyxlnt_assert(ws.cell("A1").font().italic());
+        xyxlnt_assert(!ws.cell("A500").font().bold());
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        // only the default format and the final format of the cells remain
+        xyxlnt::detail::vector_istreambuf buffer(data);
+        std::istream stream(&buffer);
+        xyxlnt::detail::izstream archive(stream);
+        const auto styles = archive.read(xyxlnt::path("xl/styles.xml"));
+        xyxlnt_assert_differs(styles.find("<cellXfs count=\"2\">"), std::string::npos);
+        // the bold font is no longer used by any format
+        xyxlnt_assert_differs(styles.find("<fonts count=\"2\">"), std::string::npos);
+
+        xyxlnt::workbook loaded;
+        loaded.load(data);
+        xyxlnt_assert(loaded.active_sheet().cell("A250").font().italic());
+        xyxlnt_assert_equals(loaded.active_sheet().cell("A250").fill(), xyxlnt::fill::solid(xyxlnt::color::red()));
+    }
+
+    void test_shared_string_count()
+    {
+        auto string_count = [](const std::vector<std::uint8_t> &data) {
+            xyxlnt::detail::vector_istreambuf buffer(data);
+            std::istream stream(&buffer);
+            xyxlnt::detail::izstream archive(stream);
+            const auto table = archive.read(xyxlnt::path("xl/sharedStrings.xml"));
+            const auto start = table.find(" count=\"") + 8;
+            return std::stoul(table.substr(start, table.find('"', start) - start));
+        };
+
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value("a");
+        ws.cell("A2").value("b");
+        ws.cell("A3").value("a");
+        ws.cell("A4").value("c");
+        ws.cell("A2").value(5);
+        ws.clear_cell("A3");
+        auto copy = wb.copy_sheet(ws);
+        ws.delete_rows(1, 1);
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+        xyxlnt_assert_equals(string_count(data), 3);
+
+        wb.remove_sheet(copy);
+        data.clear();
+        wb.save(data);
+        xyxlnt_assert_equals(string_count(data), 1);
+
+        // loaded cells aren't counted as they're read, only when saving
+        xyxlnt::workbook loaded;
+        loaded.load(data);
+        loaded.active_sheet().cell("B1").value("x");
+        loaded.active_sheet().cell("A3").value(1);
+        data.clear();
+        loaded.save(data);
+        xyxlnt_assert_equals(string_count(data), 1);
+    }
+
+    void test_compact_shared_strings()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value("unused");
+        ws.cell("A2").value("a");
+        ws.cell("B1").value("b");
+        ws.cell("A1").value(1);
+        // a duplicate like the ones kept when loading
+        ws.cell("A3").value(static_cast<int>(wb.add_shared_string(xyxlnt::rich_text("a"), true)));
+        ws.cell("A3").data_type(xyxlnt::cell::type::shared_string);
+        wb.create_sheet().cell("C1").value("b");
+
+        for (std::size_t threads = 1; threads <= 2; ++threads)
+        {
+            xyxlnt::save_options options;
+            options.compact_shared_strings = true;
+            options.worksheet_threads = threads;
+
+            std::vector<std::uint8_t> data;
+            wb.save(data, options);
+
+            xyxlnt::detail::vector_istreambuf buffer(data);
+            std::istream stream(&buffer);
+            xyxlnt::detail::izstream archive(stream);
+            const auto table = archive.read(xyxlnt::path("xl/sharedStrings.xml"));
+            xyxlnt_assert_differs(table.find("count=\"4\" uniqueCount=\"2\"><si><t>b</t></si><si><t>a</t></si></sst>"), std::string::npos);
+
+            xyxlnt::workbook loaded;
+            loaded.load(data);
+            xyxlnt_assert_equals(loaded.shared_strings().size(), 2);
+            xyxlnt_assert_equals(loaded.sheet_by_index(0).cell("A2").value<std::string>(), "a");
+            xyxlnt_assert_equals(loaded.sheet_by_index(0).cell("A3").value<std::string>(), "a");
+            xyxlnt_assert_equals(loaded.sheet_by_index(0).cell("B1").value<std::string>(), "b");
+            xyxlnt_assert_equals(loaded.sheet_by_index(1).cell("C1").value<std::string>(), "b");
+        }
+
+        // the workbook keeps its own table
+        xyxlnt_assert_equals(wb.shared_strings().size(), 4);
+    }
+
+    void test_memory_usage()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        const auto empty = ws.memory_usage();
+
+        for (auto row = 1; row <= 100; ++row)
+        {
+            for (auto column = 1; column <= 10; ++column)
+            {
+                ws.cell(xyxlnt::cell_reference(column, row)).value(row * column);
+            }
+        }
+
+        const auto filled = ws.memory_usage();
+        xyxlnt_assert(filled.cells >= empty.cells + 1000 * sizeof(double));
+        xyxlnt_assert_equals(filled.comments, 0);
+
+        // cell nodes are allocated from each sheet's own arena
+        auto copy = wb.copy_sheet(ws);
+        xyxlnt_assert_equals(copy.memory_usage().cells, filled.cells);
+        xyxlnt_assert_equals(ws.memory_usage().cells, filled.cells);
+        wb.remove_sheet(copy);
+
+        // the arena keeps deleted nodes for reuse rather than returning them
+        ws.delete_rows(1, 100);
+        xyxlnt_assert_equals(ws.memory_usage().cells, filled.cells);
+
+        for (auto row = 1; row <= 100; ++row)
+        {
+            for (auto column = 1; column <= 10; ++column)
+            {
+                ws.cell(xyxlnt::cell_reference(column, row)).value(row + column);
+            }
+        }
+
+        xyxlnt_assert_equals(ws.memory_usage().cells, filled.cells);
+        ws.delete_rows(1, 100);
+
+        const auto before_text = wb.memory_usage();
+        ws.cell("A1").value(std::string(1000, 'a'));
+        ws.cell("A1").comment(xyxlnt::comment(std::string(1000, 'b'), "author"));
+        const auto usage = wb.memory_usage();
+        xyxlnt_assert(usage.shared_strings >= before_text.shared_strings + 1000);
+        xyxlnt_assert(usage.comments >= before_text.comments + 1000);
+
+        // a new workbook has a stylesheet, a thumbnail and package relationships
+        xyxlnt_assert(usage.styles > 0);
+        xyxlnt_assert(usage.images_and_binaries > 0);
+        xyxlnt_assert(usage.manifest > 0);
+        xyxlnt_assert_equals(usage.total(), usage.cells + usage.shared_strings + usage.styles
+            + usage.images_and_binaries + usage.comments + usage.manifest);
+    }
+
+    void test_format_by_index()
+    {
+        xyxlnt::workbook wb;
+        std::size_t default_formats = 0;
+
+        while (true)
+        {
+            try
+            {
+                wb.format(default_formats);
+                ++default_formats;
+            }
+            catch (const std::out_of_range &)
+            {
+                break;
+            }
+        }
+
+        for (int size = 20; size < 30; ++size)
+        {
+            wb.create_format().font(xyxlnt::font().size(size), true);
+        }
+
+        xyxlnt_assert_equals(wb.format(default_formats).font().size(), 20);
+        xyxlnt_assert_equals(wb.format(default_formats + 9).font().size(), 29);
+        xyxlnt_assert_throws(wb.format(default_formats + 10), std::out_of_range);
+    }
+
     void test_comparison()
     {
         xyxlnt::workbook wb, wb2;
@@ -22,11 +22,16 @@
 // @author: see AUTHORS file
 
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 
 
 #include <helpers/test_suite.hpp>
 #include <xyxlnt/cell/cell.hpp>
+#include <xyxlnt/styles/border.hpp>
 #include <xyxlnt/styles/font.hpp>
+#include <xyxlnt/styles/format.hpp>
+#include <xyxlnt/styles/style.hpp>
 #include <xyxlnt/workbook/workbook.hpp>
 #include <xyxlnt/worksheet/header_footer.hpp>
 #include <xyxlnt/worksheet/range.hpp>
@@ -39,6 +44,9 @@ public:
     {
         register_test(test_construction);
         register_test(test_batch_formatting);
+        register_test(test_batch_formatting_shares_formats);
+        register_test(test_batch_custom_number_format);
+        register_test(test_apply_format);
         register_test(test_clear_cells);
     }
 
@@ -100,6 +108,97 @@ public:
         xyxlnt_assert(!ws.cell("B2").has_format());
     }
     
+    static std::size_t format_count(xyxlnt::workbook &wb)
+    {
+        std::size_t count = 0;
+
+        try
+        {
+            while (true)
+            {
+                wb.format(count);
+                ++count;
+            }
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+
+        return count;
+    }
+
+    void test_batch_formatting_shares_formats()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        const auto initial_formats = format_count(wb);
+
+        ws.cell("B2").number_format(xyxlnt::number_format::percentage());
+
+        auto range = ws.range("A1:J100");
+        range.font(xyxlnt::font().bold(true));
+        range.border(xyxlnt::border().side(xyxlnt::border_side::bottom,
+            xyxlnt::border::border_property().style(xyxlnt::border_style::thin)));
+
+        // the unformatted cells and the percentage cell each keep their own format
+        xyxlnt_assert(ws.cell("A1").font().bold());
+        xyxlnt_assert(ws.cell("J100").border().side(xyxlnt::border_side::bottom).is_set());
+        xyxlnt_assert_equals(ws.cell("A1").font(), ws.cell("J100").font());
+        xyxlnt_assert(ws.cell("B2").font().bold());
+        xyxlnt_assert_equals(ws.cell("B2").number_format(), xyxlnt::number_format::percentage());
+
+        // one new format per distinct source format rather than per cell; saving
+        // collects the intermediate ones
+        std::ostringstream stream;
+        wb.save(stream);
+        xyxlnt_assert(format_count(wb) <= initial_formats);
+
+        auto heading = wb.create_style("Heading");
+        heading.font(xyxlnt::font().size(20));
+        ws.range("A1:C1").style("Heading");
+        xyxlnt_assert_equals(ws.cell("C1").style().name(), "Heading");
+        xyxlnt_assert_equals(ws.cell("C1").font().size(), 20);
+        xyxlnt_assert(!ws.cell("A2").has_style());
+    }
+
+    void test_batch_custom_number_format()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.range("A1:B2").number_format(xyxlnt::number_format("0.0000"));
+        xyxlnt_assert_equals(ws.cell("A1").number_format().format_string(), "0.0000");
+        xyxlnt_assert_equals(ws.cell("B2").number_format().id(), 164);
+
+        // the same format string applied per cell keeps the id the range gave it
+        ws.cell("C3").number_format(xyxlnt::number_format("0.0000"));
+        xyxlnt_assert_equals(ws.cell("C3").number_format().id(), 164);
+
+        ws.range("A1:A2").number_format(xyxlnt::number_format("0.000"));
+        xyxlnt_assert_equals(ws.cell("A2").number_format().id(), 165);
+        xyxlnt_assert_equals(ws.cell("B1").number_format().id(), 164);
+    }
+
+    void test_apply_format()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").font(xyxlnt::font().italic(true));
+
+        auto format = wb.create_format().font(xyxlnt::font().bold(true), true);
+        ws.range("A1:C3").apply_format(format);
+
+        xyxlnt_assert(ws.cell("C3").font().bold());
+        xyxlnt_assert(ws.cell("A1").font().bold());
+        xyxlnt_assert(!ws.cell("A1").font().italic());
+        xyxlnt_assert(!ws.cell("D4").has_format());
+
+        xyxlnt::range(ws, xyxlnt::range_reference("A1:E5"), xyxlnt::major_order::row, true)
+            .font(xyxlnt::font().italic(true));
+        xyxlnt_assert(ws.cell("B2").font().italic());
+        xyxlnt_assert(!ws.has_cell("E5"));
+    }
+
     void test_clear_cells()
     {
         xyxlnt::workbook wb;
@@ -21,8 +21,13 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <cmath>
+
 #include <xyxlnt/cell/cell.hpp>
+#include <xyxlnt/cell/comment.hpp>
 #include <xyxlnt/cell/hyperlink.hpp>
+#include <xyxlnt/styles/number_format.hpp>
+#include <xyxlnt/utils/variant.hpp>
 #include <xyxlnt/workbook/workbook.hpp>
 #include <xyxlnt/worksheet/column_properties.hpp>
 #include <xyxlnt/worksheet/header_footer.hpp>
@@ -61,6 +66,9 @@ public:
         register_test(test_merge_range_string);
         register_test(test_unmerge_bad);
         register_test(test_unmerge_range_string);
+        register_test(test_merge_overlapping);
+        register_test(test_merged_range_lookup);
+        register_test(test_merged_range_lookup_mixed_heights);
         register_test(test_defined_names);
         register_test(test_freeze_panes_horiz);
         register_test(test_freeze_panes_vert);
@@ -86,6 +94,8 @@ public:
         register_test(test_unique_sheet_name);
         register_test(test_page_margins);
         register_test(test_garbage_collect);
+        register_test(test_garbage_collect_cleared_cells);
+        register_test(test_garbage_collect_read_cells);
         register_test(test_has_cell);
         register_test(test_get_range_by_string);
         register_test(test_operators);
@@ -108,6 +118,15 @@ public:
         register_test(test_delete_columns);
         register_test(test_insert_too_many);
         register_test(test_insert_delete_moves_merges);
+        register_test(test_insert_delete_updates_formulae);
+        register_test(test_insert_delete_updates_formulae_any_title_case);
+        register_test(test_insert_delete_moves_comments);
+        register_test(test_insert_delete_keeps_cell_handles);
+        register_test(test_insert_rows_updates_copied_and_loaded_formulae);
+        register_test(test_write_block);
+        register_test(test_write_block_strings_and_variants);
+        register_test(test_read_block);
+        register_test(test_read_block_strings);
         register_test(test_hidden_sheet);
         register_test(test_xlsm_read_write);
         register_test(test_issue_484);
@@ -398,6 +417,76 @@ public:
         xyxlnt_assert_equals(ws.merged_ranges().size(), 0);
     }
 
+    void test_merge_overlapping()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.merge_cells("B2:C10");
+        ws.merge_cells("E2:F2");
+
+        xyxlnt_assert_throws(ws.merge_cells("B2:C10"), xyxlnt::invalid_parameter);
+        xyxlnt_assert_throws(ws.merge_cells("A5:B5"), xyxlnt::invalid_parameter);
+        xyxlnt_assert_throws(ws.merge_cells("A1:G1000"), xyxlnt::invalid_parameter);
+        xyxlnt_assert_throws(ws.merge_cells("C4:E4"), xyxlnt::invalid_parameter);
+        ws.merge_cells("D3:F4");
+        ws.merge_cells("A1:F1");
+
+        std::vector<xyxlnt::range_reference> expected = {xyxlnt::range_reference("A1:F1"),
+            xyxlnt::range_reference("B2:C10"), xyxlnt::range_reference("E2:F2"), xyxlnt::range_reference("D3:F4")};
+        xyxlnt_assert_equals(ws.merged_ranges(), expected);
+    }
+
+    void test_merged_range_lookup()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xyxlnt::row_t row = 1; row < 1000; row += 2)
+        {
+            ws.merge_cells(xyxlnt::range_reference(xyxlnt::cell_reference(1, row), xyxlnt::cell_reference(3, row + 1)));
+        }
+        ws.merge_cells("E1:E100");
+
+        xyxlnt_assert_equals(ws.merged_range("B6").get(), xyxlnt::range_reference("A5:C6"));
+        xyxlnt_assert_equals(ws.merged_range("E50").get(), xyxlnt::range_reference("E1:E100"));
+        xyxlnt_assert(!ws.merged_range("D6").is_set());
+        xyxlnt_assert(!ws.merged_range("E101").is_set());
+
+        ws.unmerge_cells("A5:C6");
+        xyxlnt_assert(!ws.merged_range("B6").is_set());
+
+        ws.insert_rows(1, 1);
+        xyxlnt_assert_equals(ws.merged_range("A1000").get(), xyxlnt::range_reference("A1000:C1001"));
+        xyxlnt_assert_equals(ws.merged_range("E2").get(), xyxlnt::range_reference("E2:E101"));
+    }
+
+    void test_merged_range_lookup_mixed_heights()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.merge_cells("G1:G1000000");
+        ws.merge_cells("A999990:C999999");
+        for (xyxlnt::row_t row = 1; row < 1000; ++row)
+        {
+            ws.merge_cells(xyxlnt::range_reference(xyxlnt::cell_reference(1, row), xyxlnt::cell_reference(2, row)));
+        }
+
+        xyxlnt_assert_equals(ws.merged_range("G1000000").get(), xyxlnt::range_reference("G1:G1000000"));
+        xyxlnt_assert_equals(ws.merged_range("C999995").get(), xyxlnt::range_reference("A999990:C999999"));
+        xyxlnt_assert_equals(ws.merged_range("B500").get(), xyxlnt::range_reference("A500:B500"));
+        xyxlnt_assert(!ws.merged_range("C500").is_set());
+        xyxlnt_assert_throws(ws.merge_cells("F500000:G500000"), xyxlnt::invalid_parameter);
+
+        ws.unmerge_cells("G1:G1000000");
+        xyxlnt_assert(!ws.merged_range("G500000").is_set());
+        ws.merge_cells("F500000:G500000");
+        xyxlnt_assert_equals(ws.merged_range("G500000").get(), xyxlnt::range_reference("F500000:G500000"));
+        xyxlnt_assert_equals(ws.merged_ranges().size(), 1001);
+        xyxlnt_assert_equals(ws.merged_ranges().front(), xyxlnt::range_reference("A1:B1"));
+        xyxlnt_assert_equals(ws.merged_ranges().back(), xyxlnt::range_reference("A999990:C999999"));
+    }
+
     void test_defined_names()
     {
         xyxlnt::workbook wb;
@@ -964,6 +1053,80 @@ public:
         xyxlnt_assert_equals(dimensions, xyxlnt::range_reference("B2", "B2"));
     }
 
+    void test_garbage_collect_read_cells()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("B2").value(1);
+        xyxlnt_assert(!ws.cell("Z100").has_value());
+
+        for (auto row : ws.rows(false))
+        {
+            for (auto cell : row)
+            {
+                cell.has_value();
+            }
+        }
+
+        ws.garbage_collect();
+
+        xyxlnt_assert(!ws.has_cell("Z100"));
+        xyxlnt_assert(!ws.has_cell("A1"));
+        xyxlnt_assert_equals(ws.calculate_dimension(), xyxlnt::range_reference("B2:B2"));
+    }
+
+    void test_garbage_collect_cleared_cells()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("A1").value(1);
+        ws.cell("B1").value("text");
+        ws.cell("C1").formula("=A1");
+        ws.cell("D1").number_format(xyxlnt::number_format::percentage());
+        ws.cell("E1"); // never given a value
+        ws.garbage_collect();
+        xyxlnt_assert(!ws.has_cell("E1"));
+
+        ws.cell("A1").clear_value();
+        ws.cell("B1").value(nullptr);
+        ws.cell("C1").clear_formula();
+        ws.cell("D1").clear_format();
+        ws.garbage_collect();
+
+        xyxlnt_assert(!ws.has_cell("A1"));
+        xyxlnt_assert(!ws.has_cell("B1"));
+        xyxlnt_assert(!ws.has_cell("C1"));
+        xyxlnt_assert(!ws.has_cell("D1"));
+
+        // cells that were emptied and then refilled are kept
+        ws.cell("A2").value(2);
+        ws.cell("A2").clear_value();
+        ws.cell("A2").value(3);
+        ws.insert_rows(1, 1);
+        ws.garbage_collect();
+
+        xyxlnt_assert_equals(ws.cell("A3").value<int>(), 3);
+
+        // pending cells move with inserted and deleted rows and columns
+        ws.cell("C5").value(5);
+        ws.cell("C5").clear_value();
+        ws.cell("D6").value(6);
+        ws.cell("D6").clear_value();
+        ws.cell("D6").value(7);
+        ws.cell("E7").value(8);
+        ws.cell("E7").clear_value();
+        ws.insert_rows(4, 2);
+        ws.insert_columns(1, 1);
+        ws.delete_rows(9, 1);
+        ws.garbage_collect();
+
+        xyxlnt_assert(!ws.has_cell("D7"));
+        xyxlnt_assert_equals(ws.cell("E8").value<int>(), 7);
+        xyxlnt_assert_equals(ws.calculate_dimension(), xyxlnt::range_reference("B3:E8"));
+    }
+
     void test_has_cell()
     {
         xyxlnt::workbook wb;
@@ -1604,6 +1767,231 @@ public:
         }
     }
 
+    void test_insert_delete_updates_formulae()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.title("Data");
+        auto other = wb.create_sheet();
+        other.title("Other Sheet");
+
+        ws.cell("A1").formula("=SUM(B2:B4)+$C$3&\"B2\"");
+        ws.cell("A2").formula("=LOG10(B3)");
+        other.cell("A1").formula("=Data!B3+'Other Sheet'!B3+B3");
+
+        ws.insert_rows(3, 2);
+        xyxlnt_assert_equals(ws.cell("A1").formula(), "SUM(B2:B6)+$C$5&\"B2\"");
+        xyxlnt_assert_equals(ws.cell("A2").formula(), "LOG10(B5)");
+        xyxlnt_assert_equals(other.cell("A1").formula(), "Data!B5+'Other Sheet'!B3+B3");
+
+        ws.delete_rows(5, 1);
+        xyxlnt_assert_equals(ws.cell("A1").formula(), "SUM(B2:B5)+#REF!&\"B2\"");
+        xyxlnt_assert_equals(ws.cell("A2").formula(), "LOG10(#REF!)");
+
+        ws.insert_columns(2, 1);
+        xyxlnt_assert_equals(ws.cell("A1").formula(), "SUM(C2:C5)+#REF!&\"B2\"");
+        xyxlnt_assert_equals(other.cell("A1").formula(), "Data!#REF!+'Other Sheet'!B3+B3");
+    }
+
+    void test_insert_delete_updates_formulae_any_title_case()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.title("Sheet1");
+        auto other = wb.create_sheet();
+        other.title("Summary");
+
+        other.cell("A1").formula("='sheet1'!A5+SHEET1!B6:C7+'Summary'!A5");
+        ws.cell("A1").formula("=summary!A5+sheet1!A5");
+
+        ws.insert_rows(2, 1);
+        xyxlnt_assert_equals(other.cell("A1").formula(), "'sheet1'!A6+SHEET1!B7:C8+'Summary'!A5");
+        xyxlnt_assert_equals(ws.cell("A1").formula(), "summary!A5+sheet1!A6");
+
+        other.delete_rows(5, 1);
+        xyxlnt_assert_equals(other.cell("A1").formula(), "'sheet1'!A6+SHEET1!B7:C8+'Summary'!#REF!");
+        xyxlnt_assert_equals(ws.cell("A1").formula(), "summary!#REF!+sheet1!A6");
+    }
+
+    void test_insert_delete_moves_comments()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("B2").comment("moves", "author");
+        ws.cell("B5").comment("deleted", "author");
+        ws.cell("B7").comment("also moves", "author");
+
+        ws.insert_rows(1, 1);
+        xyxlnt_assert(!ws.cell("B2").has_comment());
+        xyxlnt_assert_equals(ws.cell("B3").comment().plain_text(), "moves");
+        xyxlnt_assert_equals(ws.cell("B8").comment().plain_text(), "also moves");
+
+        ws.delete_rows(6, 1);
+        xyxlnt_assert_equals(ws.cell("B3").comment().plain_text(), "moves");
+        xyxlnt_assert_equals(ws.cell("B7").comment().plain_text(), "also moves");
+
+        ws.insert_columns(1, 2);
+        xyxlnt_assert_equals(ws.cell("D3").comment().plain_text(), "moves");
+        xyxlnt_assert_equals(ws.cell("D7").comment().plain_text(), "also moves");
+        xyxlnt_assert(!ws.has_cell("B3"));
+    }
+
+    void test_insert_delete_keeps_cell_handles()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        auto handle = ws.cell("C10");
+        handle.value(42);
+
+        ws.insert_rows(2, 5);
+        xyxlnt_assert_equals(handle.reference(), xyxlnt::cell_reference("C15"));
+        xyxlnt_assert_equals(handle.value<int>(), 42);
+        xyxlnt_assert_equals(ws.cell("C15").value<int>(), 42);
+
+        ws.delete_rows(3, 2);
+        xyxlnt_assert_equals(handle.reference(), xyxlnt::cell_reference("C13"));
+        xyxlnt_assert(!ws.has_cell("C15"));
+
+        ws.insert_columns(1, 3);
+        xyxlnt_assert_equals(handle.reference(), xyxlnt::cell_reference("F13"));
+        xyxlnt_assert_equals(handle.value<int>(), 42);
+
+        ws.delete_columns(2, 2);
+        xyxlnt_assert_equals(handle.reference(), xyxlnt::cell_reference("D13"));
+        xyxlnt_assert_equals(ws.cell("D13").value<int>(), 42);
+        xyxlnt_assert(!ws.has_cell("F13"));
+    }
+
+    void test_insert_rows_updates_copied_and_loaded_formulae()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.title("Data");
+        ws.cell("A1").formula("=B2");
+        ws.cell("A2").formula("=B3");
+        ws.cell("A2").clear_formula();
+        auto copy = wb.copy_sheet(ws, 0);
+        copy.cell("A3").hyperlink(ws.cell("B4"));
+
+        ws.insert_rows(2, 1);
+        xyxlnt_assert_equals(ws.cell("A1").formula(), "B3");
+        xyxlnt_assert_equals(copy.cell("A1").formula(), "B2");
+        xyxlnt_assert_equals(copy.cell("A3").hyperlink().target_range(), "Data!B5");
+        xyxlnt_assert(!copy.cell("A2").has_formula());
+
+        copy.insert_rows(1, 1);
+        xyxlnt_assert_equals(copy.cell("A2").formula(), "B3");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+        xyxlnt::workbook loaded;
+        loaded.load(data);
+        loaded.sheet_by_title("Data").delete_rows(3, 1);
+        xyxlnt_assert_equals(loaded.sheet_by_title("Data").cell("A1").formula(), "#REF!");
+    }
+
+    void test_write_block()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("C3").value("overwritten");
+        ws.cell("C3").number_format(xyxlnt::number_format::percentage());
+
+        // 2x3 block taken from a 2x4 row-major array
+        const double values[] = {1, 2, 3, -1, 4, 5, 6, -1};
+        ws.write_block(xyxlnt::cell_reference("B2"), 2, 3, values, 4);
+
+        xyxlnt_assert_equals(ws.cell("B2").value<double>(), 1.0);
+        xyxlnt_assert_equals(ws.cell("D2").value<double>(), 3.0);
+        xyxlnt_assert_equals(ws.cell("B3").value<double>(), 4.0);
+        xyxlnt_assert_equals(ws.cell("D3").value<double>(), 6.0);
+        xyxlnt_assert_equals(ws.cell("C3").data_type(), xyxlnt::cell::type::number);
+        xyxlnt_assert_equals(ws.cell("C3").number_format(), xyxlnt::number_format::percentage());
+        xyxlnt_assert(!ws.has_cell("E2"));
+        xyxlnt_assert_equals(ws.calculate_dimension(), xyxlnt::range_reference("B2:D3"));
+
+        ws.write_block(xyxlnt::cell_reference("A1"), 0, 3, values);
+        xyxlnt_assert(!ws.has_cell("A1"));
+
+        xyxlnt_assert_throws(ws.write_block(xyxlnt::cell_reference(1, 4294967295u), 2, 1, values),
+            xyxlnt::invalid_parameter);
+    }
+
+    void test_write_block_strings_and_variants()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        const std::string strings[] = {"a", "b", "a", "c"};
+        ws.write_block(xyxlnt::cell_reference("A1"), 2, 2, strings);
+        xyxlnt_assert_equals(ws.cell("A1").data_type(), xyxlnt::cell::type::shared_string);
+        xyxlnt_assert_equals(ws.cell("B2").value<std::string>(), "c");
+        xyxlnt_assert_equals(ws.cell("A2").value<std::string>(), "a");
+        xyxlnt_assert_equals(wb.shared_strings().size(), 3);
+
+        const xyxlnt::variant variants[] = {xyxlnt::variant(7), xyxlnt::variant("text"),
+            xyxlnt::variant(true), xyxlnt::variant()};
+        ws.write_block(xyxlnt::cell_reference("A1"), 1, 4, variants);
+        xyxlnt_assert_equals(ws.cell("A1").value<int>(), 7);
+        xyxlnt_assert_equals(ws.cell("B1").value<std::string>(), "text");
+        xyxlnt_assert_equals(ws.cell("C1").value<bool>(), true);
+        xyxlnt_assert_equals(ws.cell("D1").data_type(), xyxlnt::cell::type::empty);
+
+        const xyxlnt::variant bad[] = {xyxlnt::variant(std::vector<std::int32_t>{1, 2})};
+        xyxlnt_assert_throws(ws.write_block(xyxlnt::cell_reference("A5"), 1, 1, bad), xyxlnt::invalid_parameter);
+    }
+
+    void test_read_block()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("B2").value(1.5);
+        ws.cell("C2").value(true);
+        ws.cell("B3").value("text");
+        ws.cell("C3").value(4);
+        ws.cell("D3").value(9); // outside the block
+
+        double values[4];
+        xyxlnt::cell_type types[4];
+        ws.read_block(xyxlnt::range_reference("B2:C3"), values, types);
+
+        xyxlnt_assert_equals(values[0], 1.5);
+        xyxlnt_assert_equals(values[1], 1.0);
+        xyxlnt_assert(std::isnan(values[2]));
+        xyxlnt_assert_equals(values[3], 4.0);
+        xyxlnt_assert_equals(types[1], xyxlnt::cell_type::boolean);
+        xyxlnt_assert_equals(types[2], xyxlnt::cell_type::shared_string);
+
+        double column_major[6];
+        ws.read_block(xyxlnt::range_reference("A2:C3"), column_major, nullptr, xyxlnt::major_order::column);
+        xyxlnt_assert(std::isnan(column_major[0]));
+        xyxlnt_assert(std::isnan(column_major[1]));
+        xyxlnt_assert_equals(column_major[2], 1.5);
+        xyxlnt_assert(std::isnan(column_major[3]));
+        xyxlnt_assert_equals(column_major[4], 1.0);
+        xyxlnt_assert_equals(column_major[5], 4.0);
+    }
+
+    void test_read_block_strings()
+    {
+        xyxlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value("shared");
+        ws.cell("B1").value(2);
+        ws.cell("A2").error("#N/A");
+
+        std::string values[4];
+        xyxlnt::cell_type types[4];
+        ws.read_block(xyxlnt::range_reference("A1:B2"), values, types, xyxlnt::major_order::column);
+
+        xyxlnt_assert_equals(values[0], "shared");
+        xyxlnt_assert_equals(values[1], "#N/A");
+        xyxlnt_assert_equals(values[2], "");
+        xyxlnt_assert_equals(values[3], "");
+        xyxlnt_assert_equals(types[2], xyxlnt::cell_type::number);
+        xyxlnt_assert_equals(types[3], xyxlnt::cell_type::empty);
+    }
+
     void test_hidden_sheet()
     {
         xyxlnt::workbook wb;